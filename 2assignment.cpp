@@ -2,37 +2,285 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
 #include <limits>
+#include <deque>
+#include <string_view>
+#include <cstdint>
+#include <cmath>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <cstring>
+#include <cstdio>
+#include <functional>
+#include <bitset>
+#include <tuple>
+#include <random>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <fstream>
+#include <fcntl.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef _WIN32
+#include <io.h>
+#define fdatasync _commit
+#define ftruncate _chsize
+#else
+#include <unistd.h>
+#endif
 using namespace std;
 
+// Operations timed by METRIC_TIMER
+enum MetricOp {
+    MetricAddGrade,
+    MetricComputeStats,
+    MetricEnroll,
+    MetricDrop,
+    MetricOpCount
+};
+
+const char* const metricOpNames[MetricOpCount] = {"gradebook_add_grade", "gradebook_compute_stats", "enrollment_enroll", "enrollment_drop"};
+
+// Call counts and latency histograms for the hot paths. Each thread
+// records into its own shard with plain relaxed stores (no locks, no
+// shared cache lines); shards are merged only when the metrics are read.
+// Latencies go into log-linear buckets in the style of an HDR histogram:
+// 16 sub-buckets per power of two, so any recorded value is known to
+// within about 6%. Build with -DNO_METRICS to compile the timers out.
+class MetricsRegistry {
+public:
+    static constexpr size_t Buckets = 61 * 16;
+
+    struct Summary {
+        uint64_t count = 0;
+        uint64_t totalNanos = 0;
+        vector<uint64_t> buckets = vector<uint64_t>(Buckets);
+
+        // Upper bound of the bucket holding the p-th percentile, in nanoseconds
+        uint64_t percentile(double p) const {
+            uint64_t rank = static_cast<uint64_t>(ceil(p / 100.0 * count)), seen = 0;
+            for (size_t i = 0; i < Buckets; ++i) {
+                seen += buckets[i];
+                if (seen >= rank && seen > 0) {
+                    return upperBound(i);
+                }
+            }
+            return 0;
+        }
+    };
+
+private:
+    struct Shard {
+        atomic<uint64_t> counts[MetricOpCount][Buckets];
+        atomic<uint64_t> totals[MetricOpCount];
+    };
+
+    mutex shardsMutex;
+    vector<unique_ptr<Shard>> shards;
+
+    Shard& localShard() {
+        thread_local Shard* shard = nullptr;
+        if (!shard) {
+            lock_guard<mutex> guard(shardsMutex);
+            shards.emplace_back(new Shard());   // value-initialized: all zero
+            shard = shards.back().get();
+        }
+        return *shard;
+    }
+
+    // Only the owning thread writes a shard, so load + store is enough
+    static void bump(atomic<uint64_t>& counter, uint64_t by) {
+        counter.store(counter.load(memory_order_relaxed) + by, memory_order_relaxed);
+    }
+
+public:
+    static size_t bucketOf(uint64_t nanos) {
+        if (nanos < 16) {
+            return nanos;
+        }
+        int msb = 63 - __builtin_clzll(nanos);
+        return (msb - 3) * 16 + ((nanos >> (msb - 4)) & 15);
+    }
+
+    static uint64_t lowerBound(size_t bucket) {
+        if (bucket < 16) {
+            return bucket;
+        }
+        return (16 + bucket % 16) << (bucket / 16 - 1);
+    }
+
+    static uint64_t upperBound(size_t bucket) {
+        return bucket + 1 < Buckets ? lowerBound(bucket + 1) : numeric_limits<uint64_t>::max();
+    }
+
+    void record(MetricOp op, uint64_t nanos) {
+        Shard& shard = localShard();
+        bump(shard.counts[op][bucketOf(nanos)], 1);
+        bump(shard.totals[op], nanos);
+    }
+
+    Summary summary(MetricOp op) {
+        Summary merged;
+        lock_guard<mutex> guard(shardsMutex);
+        for (const unique_ptr<Shard>& shard : shards) {
+            for (size_t i = 0; i < Buckets; ++i) {
+                uint64_t n = shard->counts[op][i].load(memory_order_relaxed);
+                merged.buckets[i] += n;
+                merged.count += n;
+            }
+            merged.totalNanos += shard->totals[op].load(memory_order_relaxed);
+        }
+        return merged;
+    }
+
+    // Prometheus text exposition format, one histogram per operation
+    void writePrometheus(ostream& out) {
+        out << "# HELP university_op_seconds Latency of instrumented operations.\n";
+        out << "# TYPE university_op_seconds histogram\n";
+        for (int op = 0; op < MetricOpCount; ++op) {
+            Summary s = summary(static_cast<MetricOp>(op));
+            string label = string("op=\"") + metricOpNames[op] + "\"";
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i < Buckets; ++i) {
+                if (s.buckets[i] == 0) {
+                    continue;
+                }
+                cumulative += s.buckets[i];
+                out << "university_op_seconds_bucket{" << label << ",le=\"" << upperBound(i) * 1e-9 << "\"} "
+                    << cumulative << '\n';
+            }
+            out << "university_op_seconds_bucket{" << label << ",le=\"+Inf\"} " << s.count << '\n';
+            out << "university_op_seconds_sum{" << label << "} " << s.totalNanos * 1e-9 << '\n';
+            out << "university_op_seconds_count{" << label << "} " << s.count << '\n';
+        }
+    }
+
+    // Writes the Prometheus text to a file for scraping or offline analysis
+    bool dump(const string& path) {
+        ofstream file(path, ios::trunc);
+        writePrometheus(file);
+        return static_cast<bool>(file);
+    }
+};
+
+MetricsRegistry& metrics() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+// Records the lifetime of the enclosing scope under one operation
+class MetricTimer {
+    MetricOp op;
+    chrono::steady_clock::time_point start;
+public:
+    explicit MetricTimer(MetricOp op) : op(op), start(chrono::steady_clock::now()) {}
+
+    ~MetricTimer() {
+        auto elapsed = chrono::steady_clock::now() - start;
+        metrics().record(op, chrono::duration_cast<chrono::nanoseconds>(elapsed).count());
+    }
+};
+
+#ifdef NO_METRICS
+#define METRIC_TIMER(op) ((void)0)
+#else
+#define METRIC_TIMER(op) MetricTimer metricTimer(op)
+#endif
+
+// Handle to a string stored once in the StringPool
+typedef uint32_t StringId;
+
+// StringPool Class
+// Keeps one copy of every ID, course code, department and program name and
+// hands out 32-bit handles, so maps and comparisons work on integers.
+// Handle 0 is always the empty string. Safe to use from several threads.
+class StringPool {
+private:
+    deque<string> strings;                   // deque keeps addresses stable for the views below
+    unordered_map<string_view, StringId> ids;
+    mutable shared_mutex poolMutex;
+
+public:
+    static constexpr StringId npos = numeric_limits<StringId>::max();
+
+    StringPool() { intern(""); }
+
+    StringId intern(string_view text) {
+        {
+            shared_lock<shared_mutex> reading(poolMutex);
+            auto it = ids.find(text);
+            if (it != ids.end()) return it->second;
+        }
+        unique_lock<shared_mutex> writing(poolMutex);
+        auto it = ids.find(text);
+        if (it != ids.end()) return it->second;
+        StringId id = strings.size();
+        strings.emplace_back(text);
+        ids.emplace(strings.back(), id);
+        return id;
+    }
+
+    // Looks up a string without adding it; returns npos if it was never interned
+    StringId find(string_view text) const {
+        shared_lock<shared_mutex> reading(poolMutex);
+        auto it = ids.find(text);
+        return it != ids.end() ? it->second : npos;
+    }
+
+    const string& str(StringId id) const {
+        shared_lock<shared_mutex> reading(poolMutex);
+        return strings[id];
+    }
+
+    size_t size() const {
+        shared_lock<shared_mutex> reading(poolMutex);
+        return strings.size();
+    }
+};
+
+StringPool& stringPool() {
+    static StringPool pool;
+    return pool;
+}
+
 // Person Class
 class Person {
 private:
     string Name;
     int age;
-    string ID;
+    StringId ID = 0;
     string contact;
 
 public:
-    Person(string name, int age, string id, string contact) {
-        setName(name);
+    // Text parameters are sinks: pass temporaries (or std::move) and each
+    // string is built once, straight into its member.
+    Person(string name, int age, string_view id, string contact) {
+        setName(std::move(name));
         setAge(age);
         setID(id);
-        setContact(contact);
+        setContact(std::move(contact));
     }
 
     virtual ~Person() {}
 
     // Getters
-    string getName() const { return Name; }
+    const string& getName() const { return Name; }
     int getAge() const { return age; }
-    string getID() const { return ID; }
-    string getContact() const { return contact; }
+    const string& getID() const { return stringPool().str(ID); }
+    StringId getIDHandle() const { return ID; }
+    const string& getContact() const { return contact; }
 
     // Setters with validation
     void setName(string name) {
         if (!name.empty())
-            Name = name;
+            Name = std::move(name);
         else
             cout << "Error: Name cannot be empty.\n";
     }
@@ -44,13 +292,13 @@ public:
             cout << "Error: Age must be between 1 and 130.\n";
     }
 
-    void setID(string id) { ID = id; }
+    void setID(string_view id) { ID = stringPool().intern(id); }
 
-    void setContact(string contact) { this->contact = contact; }
+    void setContact(string contact) { this->contact = std::move(contact); }
 
     // Virtual method to be overridden by subclasses
     virtual void displayDetails() const {
-        cout << "Person Name: " << Name << ", Age: " << age << ", ID: " << ID << ", Contact: " << contact << endl;
+        cout << "Person Name: " << Name << ", Age: " << age << ", ID: " << getID() << ", Contact: " << contact << '\n';
     }
 
     // Virtual method to calculate payment
@@ -62,23 +310,25 @@ public:
 // Student Class
 class Student : public Person {
 private:
-    string enrollment_date;
-    string program;
+    StringId enrollment_date;   // interned: a cohort shares a handful of dates
+    StringId program;
     float GPA;
 
 public:
-    Student(string name, int age, string id, string contact, string enrollment_date, string program, float GPA)
-        : Person(name, age, id, contact), enrollment_date(enrollment_date), program(program), GPA(GPA) {}
+    Student(string name, int age, string_view id, string contact, string_view enrollment_date, string_view program, float GPA)
+        : Person(std::move(name), age, id, std::move(contact)), enrollment_date(stringPool().intern(enrollment_date)),
+          program(stringPool().intern(program)), GPA(GPA) {}
 
     ~Student() {}
 
-    string getEnrollmentDate() const { return enrollment_date; }
-    string getProgram() const { return program; }
+    const string& getEnrollmentDate() const { return stringPool().str(enrollment_date); }
+    const string& getProgram() const { return stringPool().str(program); }
+    StringId getProgramHandle() const { return program; }
     float getGPA() const { return GPA; }
 
     void displayDetails() const override {
         Person::displayDetails();
-        cout << "Enrollment Date: " << enrollment_date << ", Program: " << program << ", GPA: " << GPA << endl;
+        cout << "Enrollment Date: " << getEnrollmentDate() << ", Program: " << getProgram() << ", GPA: " << GPA << '\n';
     }
 
     float calculatePayment() const override {
@@ -89,23 +339,26 @@ public:
 // Professor Class
 class Professor : public Person {
 private:
-    string department;
-    string specialization;
-    string hire_date;
+    StringId department;
+    StringId specialization;
+    StringId hire_date;
 
 public:
-    Professor(string name, int age, string id, string contact, string department, string specialization, string hire_date)
-        : Person(name, age, id, contact), department(department), specialization(specialization), hire_date(hire_date) {}
+    Professor(string name, int age, string_view id, string contact, string_view department, string_view specialization,
+              string_view hire_date)
+        : Person(std::move(name), age, id, std::move(contact)), department(stringPool().intern(department)),
+          specialization(stringPool().intern(specialization)), hire_date(stringPool().intern(hire_date)) {}
 
     ~Professor() {}
 
-    string getDepartment() const { return department; }
-    string getSpecialization() const { return specialization; }
-    string getHireDate() const { return hire_date; }
+    const string& getDepartment() const { return stringPool().str(department); }
+    StringId getDepartmentHandle() const { return department; }
+    const string& getSpecialization() const { return stringPool().str(specialization); }
+    const string& getHireDate() const { return stringPool().str(hire_date); }
 
     void displayDetails() const override {
         Person::displayDetails();
-        cout << "Department: " << department << ", Specialization: " << specialization << ", Hire Date: " << hire_date << endl;
+        cout << "Department: " << getDepartment() << ", Specialization: " << getSpecialization() << ", Hire Date: " << getHireDate() << '\n';
     }
 
     float calculatePayment() const override {
@@ -113,109 +366,1893 @@ public:
     }
 };
 
+// Summary of all grades, gathered in a single pass over the grade column
+struct GradeStats {
+    size_t count = 0;
+    double sum = 0.0;
+    float lowest = 0.0;
+    float highest = 0.0;
+    size_t belowPassMark = 0;
+    size_t histogram[10] = {}; // 10-point buckets, 100 falls in the last one
+};
+
+// GradeDistribution Class
+// Order-statistic index over grades in [0, 100]. Grades fall into 0.1-wide
+// buckets; a Fenwick tree over bucket counts finds the bucket holding the
+// k-th grade in O(log buckets), and each bucket keeps its distinct values
+// sorted with a count. Supports removal, so overwritten grades are cheap.
+// The ~32 KB of tree and buckets is allocated on the first add, so empty
+// distributions (one per GradeBook and per shard) cost only their handles.
+class GradeDistribution {
+private:
+    static const int Buckets = 1001;
+    vector<size_t> tree;                              // Fenwick tree, 1-based
+    vector<vector<pair<float, size_t>>> buckets;      // sorted (grade, count)
+    size_t total = 0;
+
+    static int bucketOf(float grade) {
+        int b = static_cast<int>(grade * 10.0f);
+        return b < 0 ? 0 : (b >= Buckets ? Buckets - 1 : b);
+    }
+
+    void adjust(int bucket, long delta) {
+        for (int i = bucket + 1; i <= Buckets; i += i & -i)
+            tree[i] += delta;
+    }
+
+    // Grades in buckets [0, bucket)
+    size_t prefix(int bucket) const {
+        size_t sum = 0;
+        for (int i = bucket; i > 0; i -= i & -i)
+            sum += tree[i];
+        return sum;
+    }
+
+public:
+    GradeDistribution() {}
+
+    size_t size() const { return total; }
+
+    void add(float grade) {
+        if (tree.empty()) {
+            tree.assign(Buckets + 1, 0);
+            buckets.resize(Buckets);
+        }
+        int b = bucketOf(grade);
+        auto& values = buckets[b];
+        auto it = lower_bound(values.begin(), values.end(), make_pair(grade, size_t(0)));
+        if (it != values.end() && it->first == grade)
+            it->second++;
+        else
+            values.insert(it, make_pair(grade, size_t(1)));
+        adjust(b, 1);
+        total++;
+    }
+
+    void remove(float grade) {
+        if (total == 0) return;
+        int b = bucketOf(grade);
+        auto& values = buckets[b];
+        auto it = lower_bound(values.begin(), values.end(), make_pair(grade, size_t(0)));
+        if (it == values.end() || it->first != grade) return;
+        if (--it->second == 0)
+            values.erase(it);
+        adjust(b, -1);
+        total--;
+    }
+
+    // k-th smallest grade, 0-based; k must be below size()
+    float select(size_t k) const {
+        int pos = 0;
+        for (int step = 1024; step > 0; step >>= 1) {
+            if (pos + step <= Buckets && tree[pos + step] <= k) {
+                pos += step;
+                k -= tree[pos];
+            }
+        }
+        for (auto& value : buckets[pos]) {
+            if (k < value.second) return value.first;
+            k -= value.second;
+        }
+        return 0.0;
+    }
+
+    size_t countBelow(float mark) const {
+        if (mark <= 0.0 || total == 0) return 0;
+        int b = bucketOf(mark);
+        size_t count = prefix(b);
+        for (auto& value : buckets[b]) {
+            if (value.first >= mark) break;
+            count += value.second;
+        }
+        return count;
+    }
+
+    float lowest() const { return total ? select(0) : 0.0; }
+    float highest() const { return total ? select(total - 1) : 0.0; }
+
+    float median() const {
+        if (total == 0) return 0.0;
+        if (total % 2) return select(total / 2);
+        return (select(total / 2 - 1) + select(total / 2)) / 2.0f;
+    }
+
+    // Nearest-rank percentile, p in [0, 100]
+    float percentile(float p) const {
+        if (total == 0) return 0.0;
+        double rank = ceil(p / 100.0 * total);
+        size_t k = rank < 1.0 ? 0 : min(total - 1, static_cast<size_t>(rank) - 1);
+        return select(k);
+    }
+};
+
+// TranscriptLedger Class
+// Credit-weighted GPA per student, derived from course grades. Every grade
+// change only sets the student's dirty bit; the GPA is recomputed on the
+// next read of that student or at closeTerm(), which handles the dirty
+// students in parallel and never touches the rest. Grades map to points in
+// bands: 90+ is 4.0, 80+ is 3.0, 70+ is 2.0, 60+ is 1.0, lower is 0.
+class TranscriptLedger {
+private:
+    struct CourseGrade {
+        StringId course;
+        float grade;
+    };
+
+    struct Transcript {
+        vector<CourseGrade> grades;   // one per course, latest grade wins
+        float gpa = 0.0;
+        bool dirty = false;           // gpa is stale
+        bool queued = false;          // slot is in dirtyList
+    };
+
+    static constexpr float DefaultCredits = 3.0;
+
+    unordered_map<StringId, float> courseCredits;
+    unordered_map<StringId, uint32_t> index;   // studentID -> position in transcripts
+    unordered_map<StringId, vector<uint32_t>> courseStudents;   // courseCode -> graded transcripts
+    vector<Transcript> transcripts;
+    vector<uint32_t> dirtyList;                // each slot at most once; may be clean after getGPA
+
+    static float gradePoints(float grade) {
+        return grade >= 90 ? 4.0f : grade >= 80 ? 3.0f : grade >= 70 ? 2.0f : grade >= 60 ? 1.0f : 0.0f;
+    }
+
+    float credits(StringId course) const {
+        auto it = courseCredits.find(course);
+        return it != courseCredits.end() ? it->second : DefaultCredits;
+    }
+
+    void recompute(Transcript& transcript) const {
+        float points = 0.0, weight = 0.0;
+        for (const CourseGrade& entry : transcript.grades) {
+            float w = credits(entry.course);
+            points += gradePoints(entry.grade) * w;
+            weight += w;
+        }
+        transcript.gpa = weight > 0 ? points / weight : 0.0f;
+        transcript.dirty = false;
+    }
+
+    void markDirty(uint32_t slot) {
+        Transcript& transcript = transcripts[slot];
+        transcript.dirty = true;
+        if (!transcript.queued) {
+            transcript.queued = true;
+            dirtyList.push_back(slot);
+        }
+    }
+
+public:
+    // Credit weight of a course (3 if never set); marks its students dirty
+    void setCredits(StringId courseCode, float credits) {
+        courseCredits[courseCode] = credits;
+        auto students = courseStudents.find(courseCode);
+        if (students == courseStudents.end()) return;
+        for (uint32_t slot : students->second) markDirty(slot);
+    }
+
+    void recordGrade(StringId courseCode, StringId studentID, float grade) {
+        auto result = index.emplace(studentID, transcripts.size());
+        if (result.second) transcripts.emplace_back();
+        uint32_t slot = result.first->second;
+        vector<CourseGrade>& grades = transcripts[slot].grades;
+        auto it = find_if(grades.begin(), grades.end(), [&](const CourseGrade& e) { return e.course == courseCode; });
+        if (it != grades.end()) {
+            it->grade = grade;
+        } else {
+            grades.push_back({courseCode, grade});
+            courseStudents[courseCode].push_back(slot);
+        }
+        markDirty(slot);
+    }
+
+    // Cached GPA; a dirty student is recomputed from their own grades only.
+    // That makes this a write, so like the rest of the ledger it must not
+    // run concurrently with any other call.
+    float getGPA(StringId studentID) {
+        auto it = index.find(studentID);
+        if (it == index.end()) return 0.0;
+        Transcript& transcript = transcripts[it->second];
+        if (transcript.dirty) recompute(transcript);
+        return transcript.gpa;
+    }
+
+    float getGPA(const string& studentID) { return getGPA(stringPool().find(studentID)); }
+
+    size_t getDirtyCount() const {
+        size_t dirty = 0;
+        for (uint32_t slot : dirtyList) dirty += transcripts[slot].dirty;
+        return dirty;
+    }
+
+    // Term-end pass: recomputes every dirty student on up to `threads`
+    // workers (0 = one per core); returns how many were recomputed
+    size_t closeTerm(unsigned threads = 0) {
+        vector<uint32_t> work;
+        work.reserve(dirtyList.size());
+        for (uint32_t slot : dirtyList) {
+            transcripts[slot].queued = false;
+            if (transcripts[slot].dirty) work.push_back(slot);
+        }
+        dirtyList.clear();
+
+        if (!threads) threads = max(1u, thread::hardware_concurrency());
+        threads = static_cast<unsigned>(min<size_t>(threads, max<size_t>(1, work.size() / 4096)));
+        auto worker = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) recompute(transcripts[work[i]]);
+        };
+        vector<thread> workers;
+        size_t per = (work.size() + threads - 1) / threads;
+        for (unsigned t = 1; t < threads; ++t)
+            workers.emplace_back(worker, min(work.size(), t * per), min(work.size(), (t + 1) * per));
+        worker(0, min(work.size(), per));
+        for (thread& t : workers) t.join();
+        return work.size();
+    }
+};
+
 // GradeBook Class
 class GradeBook {
 private:
-    map<string, float> grades; // studentID -> grade
+    unordered_map<StringId, size_t> index;   // studentID -> position in the columns below
+    vector<StringId> studentIDs;
+    vector<float> gradeValues;
+
+    // Maintained on every addGrade so dashboard reads never rescan
+    double runningSum = 0.0;
+    GradeDistribution distribution;
+
+    // Column positions ordered by student ID text, for reports
+    vector<size_t> sortedPositions() const {
+        vector<size_t> order(studentIDs.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        const StringPool& pool = stringPool();
+        sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return pool.str(studentIDs[a]) < pool.str(studentIDs[b]);
+        });
+        return order;
+    }
+
+    // Optional ledger that every accepted grade is forwarded to
+    TranscriptLedger* ledger = nullptr;
+    StringId courseCode = 0;
 
 public:
     GradeBook() {}
 
-    void addGrade(string studentID, float grade) {
+    // Feeds this course's grades into a TranscriptLedger from now on
+    void attachLedger(TranscriptLedger& transcripts, StringId course) {
+        ledger = &transcripts;
+        courseCode = course;
+    }
+
+    void addGrade(StringId studentID, float grade) {
+        METRIC_TIMER(MetricAddGrade);
         if (grade >= 0.0 && grade <= 100.0) {
-            grades[studentID] = grade;
-            cout << "Grade added for student " << studentID << endl;
+            auto it = index.find(studentID);
+            if (it != index.end()) {
+                float& old = gradeValues[it->second];
+                runningSum -= old;
+                distribution.remove(old);
+                old = grade;
+            } else {
+                index.emplace(studentID, gradeValues.size());
+                studentIDs.push_back(studentID);
+                gradeValues.push_back(grade);
+            }
+            runningSum += grade;
+            distribution.add(grade);
+            if (ledger) ledger->recordGrade(courseCode, studentID, grade);
+            cout << "Grade added for student " << stringPool().str(studentID) << endl;
         } else {
             cout << "Error: Grade must be between 0 and 100." << endl;
         }
     }
 
+    void addGrade(const string& studentID, float grade) {
+        addGrade(stringPool().intern(studentID), grade);
+    }
+
     void displayGrades() const {
-        cout << "\nGradeBook Entries:" << endl;
-        for (auto& entry : grades) {
-            cout << "Student ID: " << entry.first << ", Grade: " << entry.second << endl;
+        cout << "\nGradeBook Entries:" << '\n';
+        for (size_t i : sortedPositions()) {
+            cout << "Student ID: " << stringPool().str(studentIDs[i]) << ", Grade: " << gradeValues[i] << '\n';
         }
     }
 
-    float calculateAverageGrade() const {
-        if (grades.empty()) return 0.0;
-        float sum = 0.0;
-        for (auto& entry : grades) {
-            sum += entry.second;
+    // Two passes over the contiguous grade column. The first gathers the
+    // sum, min, max and failing count; GCC will not vectorize a float
+    // min/max or a double sum without -ffast-math, so on x86 it uses SSE2
+    // directly, four grades per step, with a scalar tail. The sum is kept
+    // in double so long columns do not drift. The second pass fills the
+    // histogram, whose scattered increments stay scalar.
+    GradeStats computeStats(float passMark = 40.0) const {
+        METRIC_TIMER(MetricComputeStats);
+        GradeStats stats;
+        stats.count = gradeValues.size();
+        if (gradeValues.empty()) return stats;
+
+        const float* grades = gradeValues.data();
+        const size_t n = stats.count;
+        size_t i = 0;
+        double sum = 0.0;
+        float lowest = numeric_limits<float>::max();
+        float highest = numeric_limits<float>::lowest();
+        size_t below = 0;
+#ifdef __SSE2__
+        __m128 lo4 = _mm_set1_ps(lowest), hi4 = _mm_set1_ps(highest), pass4 = _mm_set1_ps(passMark);
+        __m128d sumLow = _mm_setzero_pd(), sumHigh = _mm_setzero_pd();
+        __m128i below4 = _mm_setzero_si128();
+        for (; i + 4 <= n; i += 4) {
+            __m128 g = _mm_loadu_ps(grades + i);
+            lo4 = _mm_min_ps(lo4, g);
+            hi4 = _mm_max_ps(hi4, g);
+            below4 = _mm_sub_epi32(below4, _mm_castps_si128(_mm_cmplt_ps(g, pass4)));   // true lanes are -1
+            sumLow = _mm_add_pd(sumLow, _mm_cvtps_pd(g));
+            sumHigh = _mm_add_pd(sumHigh, _mm_cvtps_pd(_mm_movehl_ps(g, g)));
+        }
+        float lo[4], hi[4];
+        double sums[2];
+        int32_t counts[4];
+        _mm_storeu_ps(lo, lo4);
+        _mm_storeu_ps(hi, hi4);
+        _mm_storeu_pd(sums, _mm_add_pd(sumLow, sumHigh));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(counts), below4);
+        for (int lane = 0; lane < 4; ++lane) {
+            lowest = min(lowest, lo[lane]);
+            highest = max(highest, hi[lane]);
+            below += static_cast<uint32_t>(counts[lane]);
+        }
+        sum = sums[0] + sums[1];
+#endif
+        for (; i < n; ++i) {
+            float g = grades[i];
+            sum += g;
+            lowest = g < lowest ? g : lowest;
+            highest = g > highest ? g : highest;
+            below += g < passMark;
         }
-        return sum / grades.size();
-    }
 
-    float getHighestGrade() const {
-        if (grades.empty()) return 0.0;
-        float highest = numeric_limits<float>::min();
-        for (auto& entry : grades) {
-            if (entry.second > highest)
-                highest = entry.second;
+        for (size_t j = 0; j < n; ++j) {
+            size_t bucket = static_cast<size_t>(grades[j] / 10.0f);
+            stats.histogram[bucket < 9 ? bucket : 9]++;
         }
-        return highest;
+        stats.sum = sum;
+        stats.lowest = lowest;
+        stats.highest = highest;
+        stats.belowPassMark = below;
+        return stats;
+    }
+
+    float calculateAverageGrade() const {
+        if (gradeValues.empty()) return 0.0;
+        return runningSum / gradeValues.size();
     }
 
+    float getHighestGrade() const { return distribution.highest(); }
+    float getLowestGrade() const { return distribution.lowest(); }
+    float getMedianGrade() const { return distribution.median(); }
+    float getPercentile(float p) const { return distribution.percentile(p); }
+    size_t getFailingCount(float passMark = 40.0) const { return distribution.countBelow(passMark); }
+
     vector<string> getFailingStudents(float passMark = 40.0) const {
         vector<string> failing;
-        for (auto& entry : grades) {
-            if (entry.second < passMark)
-                failing.push_back(entry.first);
+        for (size_t i : sortedPositions()) {
+            if (gradeValues[i] < passMark)
+                failing.push_back(stringPool().str(studentIDs[i]));
         }
         return failing;
     }
 };
 
+enum RegistrationAction {
+    RegisterEnroll,
+    RegisterDrop
+};
+
+struct RegistrationRequest {
+    StringId courseCode;
+    StringId studentID;
+    RegistrationAction action = RegisterEnroll;
+};
+
+enum RegistrationStatus {
+    NotRegistered,      // drop for a student neither enrolled nor waiting
+    Enrolled,
+    Waitlisted,
+    AlreadyEnrolled,
+    AlreadyWaitlisted,
+    Dropped,
+    LeftWaitlist
+};
+
+struct RegistrationOutcome {
+    RegistrationStatus status = NotRegistered;
+    StringId promoted = StringPool::npos;   // student seated from the waitlist by this drop
+};
+
 // EnrollmentManager Class
+// A course may have a seat limit; enrollments past it join a FIFO waitlist
+// and each freed seat goes to the longest-waiting student.
 class EnrollmentManager {
 private:
-    map<string, vector<string>> courseEnrollments; // courseCode -> list of studentIDs
+    struct CourseRoster {
+        vector<StringId> students;                 // dense list, order changes on drop
+        unordered_map<StringId, size_t> position;  // studentID -> index in students
+        size_t capacity = numeric_limits<size_t>::max();
+        deque<pair<StringId, uint64_t>> waitlist;  // (studentID, ticket), oldest first
+        unordered_map<StringId, uint64_t> waiting; // studentID -> live ticket; other entries are stale
+        uint64_t nextTicket = 0;
+    };
+
+    // Edit to the studentID -> courseCodes index made by a roster operation
+    struct RosterChange {
+        StringId student;
+        bool added;
+    };
+
+    unordered_map<StringId, CourseRoster> courseEnrollments;             // courseCode -> roster
+    unordered_map<StringId, vector<StringId>> studentCourses;            // studentID -> courseCodes, unordered
+    size_t totalEnrollments = 0;
+    vector<RosterChange> pendingChanges;
+
+    // The roster operations below touch one course only and do no I/O, so
+    // registerBatch can run different courses on different threads. Their
+    // index edits are collected in `changes` and applied by the caller.
+    static void seat(CourseRoster& roster, StringId student, vector<RosterChange>& changes) {
+        roster.position.emplace(student, roster.students.size());
+        roster.students.push_back(student);
+        changes.push_back({student, true});
+    }
+
+    // An entry is live while its ticket is the student's current one
+    static bool isLive(const CourseRoster& roster, const pair<StringId, uint64_t>& entry) {
+        auto it = roster.waiting.find(entry.first);
+        return it != roster.waiting.end() && it->second == entry.second;
+    }
+
+    // Fills free seats from the waitlist; returns the last student seated, or npos
+    static StringId promote(CourseRoster& roster, vector<RosterChange>& changes) {
+        StringId promoted = StringPool::npos;
+        while (roster.students.size() < roster.capacity && !roster.waitlist.empty()) {
+            pair<StringId, uint64_t> entry = roster.waitlist.front();
+            roster.waitlist.pop_front();
+            if (!isLive(roster, entry)) continue;
+            roster.waiting.erase(entry.first);
+            seat(roster, entry.first, changes);
+            promoted = entry.first;
+        }
+        return promoted;
+    }
+
+    // Leaving the waitlist only forgets the live ticket. Stale entries at
+    // the front are popped straight away, and the rest are swept once they
+    // outnumber the live ones, so the deque stays under twice the real
+    // waitlist and a leave is still O(1) amortized.
+    static void compactWaitlist(CourseRoster& roster) {
+        while (!roster.waitlist.empty() && !isLive(roster, roster.waitlist.front())) roster.waitlist.pop_front();
+        if (roster.waitlist.size() <= 2 * roster.waiting.size()) return;
+        deque<pair<StringId, uint64_t>> live;
+        for (auto& entry : roster.waitlist) {
+            if (isLive(roster, entry)) live.push_back(entry);
+        }
+        roster.waitlist.swap(live);
+    }
+
+    static RegistrationStatus enroll(CourseRoster& roster, StringId student, vector<RosterChange>& changes) {
+        if (roster.position.count(student)) return AlreadyEnrolled;
+        if (roster.waiting.count(student)) return AlreadyWaitlisted;
+        if (roster.students.size() >= roster.capacity) {
+            roster.waiting.emplace(student, roster.nextTicket);
+            roster.waitlist.emplace_back(student, roster.nextTicket++);
+            return Waitlisted;
+        }
+        seat(roster, student, changes);
+        return Enrolled;
+    }
+
+    static RegistrationOutcome drop(CourseRoster& roster, StringId student, vector<RosterChange>& changes) {
+        RegistrationOutcome outcome;
+        auto pos = roster.position.find(student);
+        if (pos == roster.position.end()) {
+            outcome.status = roster.waiting.erase(student) ? LeftWaitlist : NotRegistered;
+            if (outcome.status == LeftWaitlist) compactWaitlist(roster);
+            return outcome;
+        }
+
+        // Swap-remove: move the last student into the freed slot
+        size_t slot = pos->second;
+        roster.position.erase(pos);
+        if (slot != roster.students.size() - 1) {
+            roster.students[slot] = roster.students.back();
+            roster.position[roster.students[slot]] = slot;
+        }
+        roster.students.pop_back();
+        changes.push_back({student, false});
+
+        outcome.status = Dropped;
+        outcome.promoted = promote(roster, changes);
+        return outcome;
+    }
+
+    void apply(StringId courseCode, vector<RosterChange>& changes) {
+        for (const RosterChange& change : changes) {
+            if (change.added) {
+                studentCourses[change.student].push_back(courseCode);
+                totalEnrollments++;
+            } else {
+                // A student holds a handful of courses, so a linear scan beats a set
+                auto courses = studentCourses.find(change.student);
+                vector<StringId>& codes = courses->second;
+                *find(codes.begin(), codes.end(), courseCode) = codes.back();
+                codes.pop_back();
+                if (codes.empty())
+                    studentCourses.erase(courses);
+                totalEnrollments--;
+            }
+        }
+        changes.clear();
+    }
+
+    RegistrationOutcome dropOne(StringId courseCode, StringId studentID) {
+        METRIC_TIMER(MetricDrop);
+        auto course = courseEnrollments.find(courseCode);
+        if (course == courseEnrollments.end()) return RegistrationOutcome();
+        RegistrationOutcome outcome = drop(course->second, studentID, pendingChanges);
+        apply(courseCode, pendingChanges);
+        return outcome;
+    }
 
 public:
     EnrollmentManager() {}
 
-    void enrollStudent(string courseCode, string studentID) {
-        courseEnrollments[courseCode].push_back(studentID);
-        cout << "Student " << studentID << " enrolled in course " << courseCode << endl;
+    void enrollStudent(StringId courseCode, StringId studentID) {
+        METRIC_TIMER(MetricEnroll);
+        const StringPool& pool = stringPool();
+        RegistrationStatus status = enroll(courseEnrollments[courseCode], studentID, pendingChanges);
+        apply(courseCode, pendingChanges);
+        if (status == AlreadyEnrolled)
+            cout << "Student " << pool.str(studentID) << " already enrolled in course " << pool.str(courseCode) << endl;
+        else if (status == AlreadyWaitlisted)
+            cout << "Student " << pool.str(studentID) << " already waitlisted for course " << pool.str(courseCode) << endl;
+        else if (status == Waitlisted)
+            cout << "Student " << pool.str(studentID) << " waitlisted for course " << pool.str(courseCode) << endl;
+        else
+            cout << "Student " << pool.str(studentID) << " enrolled in course " << pool.str(courseCode) << endl;
     }
 
-    void dropStudent(string courseCode, string studentID) {
-        auto& students = courseEnrollments[courseCode];
-        for (auto it = students.begin(); it != students.end(); ++it) {
-            if (*it == studentID) {
-                students.erase(it);
-                cout << "Student " << studentID << " dropped from course " << courseCode << endl;
-                return;
+    void enrollStudent(const string& courseCode, const string& studentID) {
+        enrollStudent(stringPool().intern(courseCode), stringPool().intern(studentID));
+    }
+
+    // Removes the student from the course or its waitlist; a freed seat
+    // goes to the first waiting student
+    bool dropStudent(StringId courseCode, StringId studentID) {
+        RegistrationStatus status = dropOne(courseCode, studentID).status;
+        return status == Dropped || status == LeftWaitlist;
+    }
+
+    void dropStudent(const string& courseCode, const string& studentID) {
+        const StringPool& pool = stringPool();
+        StringId course = pool.find(courseCode);
+        StringId student = pool.find(studentID);
+        RegistrationOutcome outcome;
+        if (course != StringPool::npos && student != StringPool::npos)
+            outcome = dropOne(course, student);
+        if (outcome.status == Dropped)
+            cout << "Student " << studentID << " dropped from course " << courseCode << endl;
+        else if (outcome.status == LeftWaitlist)
+            cout << "Student " << studentID << " removed from the waitlist of course " << courseCode << endl;
+        else
+            cout << "Student " << studentID << " not found in course " << courseCode << endl;
+        if (outcome.promoted != StringPool::npos)
+            cout << "Student " << pool.str(outcome.promoted) << " enrolled in course " << courseCode << " from the waitlist" << endl;
+    }
+
+    // Seat limit for a course (unlimited by default); raising it seats waiting students
+    void setCapacity(StringId courseCode, size_t capacity) {
+        CourseRoster& roster = courseEnrollments[courseCode];
+        roster.capacity = capacity;
+        promote(roster, pendingChanges);
+        apply(courseCode, pendingChanges);
+    }
+
+    void setCapacity(const string& courseCode, size_t capacity) {
+        setCapacity(stringPool().intern(courseCode), capacity);
+    }
+
+    vector<string> getWaitlist(const string& courseCode) const {
+        auto course = courseEnrollments.find(stringPool().find(courseCode));
+        if (course == courseEnrollments.end()) return {};
+        vector<string> result;
+        for (auto& entry : course->second.waitlist) {
+            if (isLive(course->second, entry)) result.push_back(stringPool().str(entry.first));
+        }
+        return result;
+    }
+
+    // Applies a batch of registration requests without writing any output;
+    // outcomes[i] answers requests[i]. Requests are grouped by course with
+    // a counting sort that keeps submission order inside each course, so
+    // waitlists stay first come, first served. Course groups run on up to
+    // `threads` workers (0 = one per core), largest first; the workers only
+    // touch their own course's roster, and the studentID -> courseCodes
+    // index is updated afterwards on the calling thread.
+    vector<RegistrationOutcome> registerBatch(const vector<RegistrationRequest>& requests, unsigned threads = 0) {
+        vector<RegistrationOutcome> outcomes(requests.size());
+
+        unordered_map<StringId, uint32_t> groupOf;
+        vector<CourseRoster*> rosters;
+        vector<StringId> codes;
+        vector<uint32_t> group(requests.size());
+        for (size_t i = 0; i < requests.size(); ++i) {
+            auto result = groupOf.emplace(requests[i].courseCode, rosters.size());
+            if (result.second) {
+                rosters.push_back(&courseEnrollments[requests[i].courseCode]);
+                codes.push_back(requests[i].courseCode);
             }
+            group[i] = result.first->second;
         }
-        cout << "Student " << studentID << " not found in course " << courseCode << endl;
+
+        vector<size_t> start(rosters.size() + 1);
+        for (uint32_t g : group) start[g + 1]++;
+        for (size_t g = 0; g < rosters.size(); ++g) start[g + 1] += start[g];
+        vector<uint32_t> order(requests.size());
+        vector<size_t> fill(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < requests.size(); ++i) order[fill[group[i]]++] = i;
+
+        vector<uint32_t> queue(rosters.size());
+        for (uint32_t g = 0; g < queue.size(); ++g) queue[g] = g;
+        sort(queue.begin(), queue.end(), [&](uint32_t a, uint32_t b) {
+            return start[a + 1] - start[a] > start[b + 1] - start[b];
+        });
+
+        vector<vector<RosterChange>> changes(rosters.size());
+        atomic<size_t> next(0);
+        auto worker = [&] {
+            for (size_t k; (k = next.fetch_add(1, memory_order_relaxed)) < queue.size();) {
+                uint32_t g = queue[k];
+                CourseRoster& roster = *rosters[g];
+                size_t seats = min(roster.capacity, roster.students.size() + start[g + 1] - start[g]);
+                roster.students.reserve(seats);
+                roster.position.reserve(seats);
+                changes[g].reserve(start[g + 1] - start[g]);
+                for (size_t j = start[g]; j < start[g + 1]; ++j) {
+                    const RegistrationRequest& request = requests[order[j]];
+                    if (request.action == RegisterDrop)
+                        outcomes[order[j]] = drop(roster, request.studentID, changes[g]);
+                    else
+                        outcomes[order[j]].status = enroll(roster, request.studentID, changes[g]);
+                }
+            }
+        };
+
+        if (!threads) threads = max(1u, thread::hardware_concurrency());
+        threads = static_cast<unsigned>(min<size_t>(threads, max<size_t>(1, queue.size())));
+        vector<thread> workers;
+        for (unsigned t = 1; t < threads; ++t) workers.emplace_back(worker);
+        worker();
+        for (thread& t : workers) t.join();
+
+        for (size_t g = 0; g < rosters.size(); ++g) apply(codes[g], changes[g]);
+        return outcomes;
+    }
+
+    bool isEnrolled(StringId courseCode, StringId studentID) const {
+        auto course = courseEnrollments.find(courseCode);
+        return course != courseEnrollments.end() && course->second.position.count(studentID) > 0;
+    }
+
+    bool isEnrolled(const string& courseCode, const string& studentID) const {
+        return isEnrolled(stringPool().find(courseCode), stringPool().find(studentID));
     }
 
-    int getEnrollmentCount(string courseCode) const {
-        if (courseEnrollments.find(courseCode) != courseEnrollments.end()) {
-            return courseEnrollments.at(courseCode).size();
+    int getEnrollmentCount(StringId courseCode) const {
+        auto course = courseEnrollments.find(courseCode);
+        if (course != courseEnrollments.end()) {
+            return course->second.students.size();
         }
         return 0;
     }
 
+    int getEnrollmentCount(const string& courseCode) const {
+        return getEnrollmentCount(stringPool().find(courseCode));
+    }
+
+    size_t getTotalEnrollments() const { return totalEnrollments; }
+
+    // Calls f(courseCode, students) for every course roster
+    template <typename F>
+    void forEachCourse(F f) const {
+        for (auto& course : courseEnrollments)
+            f(course.first, course.second.students);
+    }
+
+    vector<string> getCoursesForStudent(const string& studentID) const {
+        auto courses = studentCourses.find(stringPool().find(studentID));
+        if (courses == studentCourses.end()) return {};
+        vector<string> result;
+        for (StringId code : courses->second) {
+            result.push_back(stringPool().str(code));
+        }
+        sort(result.begin(), result.end());
+        return result;
+    }
+
     void displayEnrollments() const {
-        cout << "\nEnrollment List:" << endl;
+        const StringPool& pool = stringPool();
+        vector<StringId> codes;
         for (auto& course : courseEnrollments) {
-            cout << "Course " << course.first << " has students: ";
-            for (const string& id : course.second) {
-                cout << id << " ";
+            codes.push_back(course.first);
+        }
+        sort(codes.begin(), codes.end(), [&](StringId a, StringId b) { return pool.str(a) < pool.str(b); });
+
+        cout << "\nEnrollment List:" << '\n';
+        for (StringId code : codes) {
+            cout << "Course " << pool.str(code) << " has students: ";
+            for (StringId id : courseEnrollments.at(code).students) {
+                cout << pool.str(id) << " ";
             }
-            cout << endl;
+            cout << '\n';
         }
     }
 };
 
+// StudentBitmap Class
+// Compressed set of student ordinals in the style of a Roaring bitmap: the
+// 32-bit space is cut into 65536-wide chunks, and each chunk is stored as a
+// sorted array of 16-bit values while it holds at most 4096 of them, or as
+// a 1024-word bitset once it is denser. Set operations work chunk by chunk,
+// and bitset-with-bitset chunks are combined word by word (a loop the
+// compiler vectorizes).
+class StudentBitmap {
+private:
+    static const uint32_t ArrayLimit = 4096;
+    static const size_t Words = 1024;
+
+    struct Container {
+        uint16_t key = 0;
+        vector<uint16_t> values;    // used while the chunk is sparse
+        vector<uint64_t> bits;      // used once the chunk is dense
+        uint32_t cardinality = 0;
+
+        bool isBitmap() const { return !bits.empty(); }
+
+        bool contains(uint16_t v) const {
+            if (isBitmap()) return (bits[v >> 6] >> (v & 63)) & 1;
+            return binary_search(values.begin(), values.end(), v);
+        }
+
+        void toBitmap() {
+            bits.assign(Words, 0);
+            for (uint16_t v : values) bits[v >> 6] |= uint64_t(1) << (v & 63);
+            values.clear();
+            values.shrink_to_fit();
+        }
+
+        // Recounts after a word-wise operation and goes back to an array if sparse
+        void normalize() {
+            if (!isBitmap()) {
+                cardinality = values.size();
+                return;
+            }
+            cardinality = 0;
+            for (uint64_t w : bits) cardinality += bitset<64>(w).count();
+            if (cardinality <= ArrayLimit) {
+                values.clear();
+                for (size_t i = 0; i < Words; i++)
+                    for (uint64_t w = bits[i]; w; w &= w - 1)
+                        values.push_back(static_cast<uint16_t>(i * 64 + __builtin_ctzll(w)));
+                bits.clear();
+            }
+        }
+
+        void add(uint16_t v) {
+            if (isBitmap()) {
+                uint64_t& word = bits[v >> 6];
+                uint64_t mask = uint64_t(1) << (v & 63);
+                if (!(word & mask)) { word |= mask; cardinality++; }
+                return;
+            }
+            auto it = lower_bound(values.begin(), values.end(), v);
+            if (it != values.end() && *it == v) return;
+            values.insert(it, v);
+            cardinality++;
+            if (cardinality > ArrayLimit) toBitmap();
+        }
+
+        const vector<uint64_t>& asBits(vector<uint64_t>& scratch) const {
+            if (isBitmap()) return bits;
+            scratch.assign(Words, 0);
+            for (uint16_t v : values) scratch[v >> 6] |= uint64_t(1) << (v & 63);
+            return scratch;
+        }
+    };
+
+    vector<Container> containers;   // sorted by key
+
+    vector<Container>::const_iterator lookup(uint16_t key) const {
+        return lower_bound(containers.begin(), containers.end(), key,
+                           [](const Container& c, uint16_t k) { return c.key < k; });
+    }
+
+    static Container intersect(const Container& a, const Container& b) {
+        Container out;
+        out.key = a.key;
+        if (!a.isBitmap() || !b.isBitmap()) {
+            const Container& small = a.isBitmap() ? b : a;
+            const Container& other = a.isBitmap() ? a : b;
+            for (uint16_t v : small.values)
+                if (other.contains(v)) out.values.push_back(v);
+        } else {
+            out.bits.resize(Words);
+            for (size_t i = 0; i < Words; i++) out.bits[i] = a.bits[i] & b.bits[i];
+        }
+        out.normalize();
+        return out;
+    }
+
+    static Container unite(const Container& a, const Container& b) {
+        Container out;
+        out.key = a.key;
+        if (!a.isBitmap() && !b.isBitmap() && a.cardinality + b.cardinality <= ArrayLimit) {
+            set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), back_inserter(out.values));
+        } else {
+            vector<uint64_t> sa, sb;
+            const vector<uint64_t>& wa = a.asBits(sa);
+            const vector<uint64_t>& wb = b.asBits(sb);
+            out.bits.resize(Words);
+            for (size_t i = 0; i < Words; i++) out.bits[i] = wa[i] | wb[i];
+        }
+        out.normalize();
+        return out;
+    }
+
+    static Container subtract(const Container& a, const Container& b) {
+        Container out;
+        out.key = a.key;
+        if (!a.isBitmap()) {
+            for (uint16_t v : a.values)
+                if (!b.contains(v)) out.values.push_back(v);
+        } else {
+            vector<uint64_t> sb;
+            const vector<uint64_t>& wb = b.asBits(sb);
+            out.bits.resize(Words);
+            for (size_t i = 0; i < Words; i++) out.bits[i] = a.bits[i] & ~wb[i];
+        }
+        out.normalize();
+        return out;
+    }
+
+public:
+    void add(uint32_t ordinal) {
+        uint16_t key = ordinal >> 16;
+        auto it = containers.begin() + (lookup(key) - containers.cbegin());
+        if (it == containers.end() || it->key != key) {
+            it = containers.insert(it, Container());
+            it->key = key;
+        }
+        it->add(ordinal & 0xFFFF);
+    }
+
+    bool contains(uint32_t ordinal) const {
+        auto it = lookup(ordinal >> 16);
+        return it != containers.end() && it->key == (ordinal >> 16) && it->contains(ordinal & 0xFFFF);
+    }
+
+    size_t cardinality() const {
+        size_t total = 0;
+        for (const Container& c : containers) total += c.cardinality;
+        return total;
+    }
+
+    vector<uint32_t> toVector() const {
+        vector<uint32_t> out;
+        out.reserve(cardinality());
+        for (const Container& c : containers) {
+            uint32_t high = uint32_t(c.key) << 16;
+            if (c.isBitmap()) {
+                for (size_t i = 0; i < Words; i++)
+                    for (uint64_t w = c.bits[i]; w; w &= w - 1)
+                        out.push_back(high | uint32_t(i * 64 + __builtin_ctzll(w)));
+            } else {
+                for (uint16_t v : c.values) out.push_back(high | v);
+            }
+        }
+        return out;
+    }
+
+    friend StudentBitmap operator&(const StudentBitmap& a, const StudentBitmap& b) {
+        StudentBitmap out;
+        size_t i = 0, j = 0;
+        while (i < a.containers.size() && j < b.containers.size()) {
+            if (a.containers[i].key < b.containers[j].key) i++;
+            else if (a.containers[i].key > b.containers[j].key) j++;
+            else {
+                Container c = intersect(a.containers[i++], b.containers[j++]);
+                if (c.cardinality) out.containers.push_back(std::move(c));
+            }
+        }
+        return out;
+    }
+
+    friend StudentBitmap operator|(const StudentBitmap& a, const StudentBitmap& b) {
+        StudentBitmap out;
+        size_t i = 0, j = 0;
+        while (i < a.containers.size() || j < b.containers.size()) {
+            if (j == b.containers.size() || (i < a.containers.size() && a.containers[i].key < b.containers[j].key))
+                out.containers.push_back(a.containers[i++]);
+            else if (i == a.containers.size() || b.containers[j].key < a.containers[i].key)
+                out.containers.push_back(b.containers[j++]);
+            else
+                out.containers.push_back(unite(a.containers[i++], b.containers[j++]));
+        }
+        return out;
+    }
+
+    // Members of a that are not in b
+    friend StudentBitmap operator-(const StudentBitmap& a, const StudentBitmap& b) {
+        StudentBitmap out;
+        size_t j = 0;
+        for (const Container& c : a.containers) {
+            while (j < b.containers.size() && b.containers[j].key < c.key) j++;
+            if (j < b.containers.size() && b.containers[j].key == c.key) {
+                Container d = subtract(c, b.containers[j]);
+                if (d.cardinality) out.containers.push_back(std::move(d));
+            } else {
+                out.containers.push_back(c);
+            }
+        }
+        return out;
+    }
+};
+
+// MembershipMatrix Class
+// Course x student membership as one StudentBitmap per course over dense
+// student ordinals, for set questions such as "students in both CS101 and
+// MATH201", "students in no course" or "courses sharing students".
+// Built from an EnrollmentManager; rebuild it after the rosters change.
+class MembershipMatrix {
+private:
+    vector<StringId> students;                       // ordinal -> studentID
+    unordered_map<StringId, uint32_t> ordinals;      // studentID -> ordinal
+    unordered_map<StringId, StudentBitmap> courses;  // courseCode -> members
+    StudentBitmap enrolled;                          // in at least one course
+
+    uint32_t ordinalOf(StringId studentID) {
+        auto result = ordinals.emplace(studentID, students.size());
+        if (result.second) students.push_back(studentID);
+        return result.first->second;
+    }
+
+    vector<string> toIDs(const StudentBitmap& members) const {
+        vector<string> ids;
+        for (uint32_t ordinal : members.toVector())
+            ids.push_back(stringPool().str(students[ordinal]));
+        return ids;
+    }
+
+    const StudentBitmap& course(const string& courseCode) const {
+        static const StudentBitmap none;
+        auto it = courses.find(stringPool().find(courseCode));
+        return it != courses.end() ? it->second : none;
+    }
+
+public:
+    // Registers students who may have no enrollments, for studentsInNoCourse()
+    void addStudent(const string& studentID) { ordinalOf(stringPool().intern(studentID)); }
+
+    void build(const EnrollmentManager& manager) {
+        courses.clear();
+        enrolled = StudentBitmap();
+        manager.forEachCourse([&](StringId code, const vector<StringId>& roster) {
+            StudentBitmap& members = courses[code];
+            for (StringId id : roster) members.add(ordinalOf(id));
+            enrolled = enrolled | members;
+        });
+    }
+
+    vector<string> studentsInAll(const vector<string>& courseCodes) const {
+        if (courseCodes.empty()) return {};
+        StudentBitmap result = course(courseCodes[0]);
+        for (size_t i = 1; i < courseCodes.size(); i++) result = result & course(courseCodes[i]);
+        return toIDs(result);
+    }
+
+    vector<string> studentsInAny(const vector<string>& courseCodes) const {
+        StudentBitmap result;
+        for (const string& code : courseCodes) result = result | course(code);
+        return toIDs(result);
+    }
+
+    vector<string> studentsInFirstOnly(const string& courseCode, const string& excluded) const {
+        return toIDs(course(courseCode) - course(excluded));
+    }
+
+    vector<string> studentsInNoCourse() const {
+        StudentBitmap all;
+        for (uint32_t i = 0; i < students.size(); i++) all.add(i);
+        return toIDs(all - enrolled);
+    }
+
+    // Every pair of courses sharing at least minShared students, with the
+    // shared count; feeds exam-conflict scheduling. Counts come from each
+    // student's own course list, so the cost follows enrollments rather
+    // than the number of course pairs.
+    vector<tuple<string, string, size_t>> coEnrollment(size_t minShared = 1) const {
+        vector<vector<StringId>> perStudent(students.size());
+        for (auto& c : courses)
+            for (uint32_t ordinal : c.second.toVector())
+                perStudent[ordinal].push_back(c.first);
+
+        map<pair<StringId, StringId>, size_t> shared;
+        for (auto& list : perStudent) {
+            sort(list.begin(), list.end());
+            for (size_t i = 0; i < list.size(); i++)
+                for (size_t j = i + 1; j < list.size(); j++)
+                    shared[{list[i], list[j]}]++;
+        }
+
+        vector<tuple<string, string, size_t>> result;
+        const StringPool& pool = stringPool();
+        for (auto& entry : shared)
+            if (entry.second >= minShared)
+                result.emplace_back(pool.str(entry.first.first), pool.str(entry.first.second), entry.second);
+        return result;
+    }
+};
+
+// ConcurrentGradeBook Class
+// GradeBook for many writer threads: grades are spread over independently
+// locked shards by student ID, so writers only contend when they hit the
+// same shard. Reports lock every shard (always in index order) and so see
+// one consistent snapshot.
+class ConcurrentGradeBook {
+private:
+    struct Shard {
+        mutable mutex lock;
+        unordered_map<StringId, float> grades;
+        double runningSum = 0.0;
+        GradeDistribution distribution;
+    };
+
+    vector<Shard> shards;
+
+    Shard& shardFor(StringId studentID) { return shards[studentID % shards.size()]; }
+
+    vector<unique_lock<mutex>> lockAll() const {
+        vector<unique_lock<mutex>> locks;
+        for (const Shard& shard : shards)
+            locks.emplace_back(shard.lock);
+        return locks;
+    }
+
+public:
+    explicit ConcurrentGradeBook(size_t shardCount = 64) : shards(shardCount ? shardCount : 1) {}
+
+    bool addGrade(StringId studentID, float grade) {
+        if (!(grade >= 0.0 && grade <= 100.0)) return false;
+        Shard& shard = shardFor(studentID);
+        lock_guard<mutex> guard(shard.lock);
+        auto result = shard.grades.emplace(studentID, grade);
+        if (!result.second) {
+            shard.runningSum -= result.first->second;
+            shard.distribution.remove(result.first->second);
+            result.first->second = grade;
+        }
+        shard.runningSum += grade;
+        shard.distribution.add(grade);
+        return true;
+    }
+
+    bool addGrade(const string& studentID, float grade) {
+        return addGrade(stringPool().intern(studentID), grade);
+    }
+
+    bool getGrade(StringId studentID, float& grade) {
+        Shard& shard = shardFor(studentID);
+        lock_guard<mutex> guard(shard.lock);
+        auto it = shard.grades.find(studentID);
+        if (it == shard.grades.end()) return false;
+        grade = it->second;
+        return true;
+    }
+
+    // Consistent copy of every (studentID, grade) pair
+    vector<pair<StringId, float>> snapshot() const {
+        auto locks = lockAll();
+        vector<pair<StringId, float>> entries;
+        for (const Shard& shard : shards)
+            entries.insert(entries.end(), shard.grades.begin(), shard.grades.end());
+        return entries;
+    }
+
+    size_t size() const {
+        auto locks = lockAll();
+        size_t count = 0;
+        for (const Shard& shard : shards) count += shard.grades.size();
+        return count;
+    }
+
+    float calculateAverageGrade() const {
+        auto locks = lockAll();
+        double sum = 0.0;
+        size_t count = 0;
+        for (const Shard& shard : shards) {
+            sum += shard.runningSum;
+            count += shard.grades.size();
+        }
+        return count ? sum / count : 0.0;
+    }
+
+    float getHighestGrade() const {
+        auto locks = lockAll();
+        float highest = 0.0;
+        for (const Shard& shard : shards)
+            if (shard.distribution.size() && shard.distribution.highest() > highest)
+                highest = shard.distribution.highest();
+        return highest;
+    }
+
+    size_t getFailingCount(float passMark = 40.0) const {
+        auto locks = lockAll();
+        size_t count = 0;
+        for (const Shard& shard : shards) count += shard.distribution.countBelow(passMark);
+        return count;
+    }
+};
+
+// ConcurrentEnrollmentManager Class
+// Rosters are sharded by course and the student -> courses index by
+// student. A write locks its course shard, then its student shard, so lock
+// order is always the same and writers never deadlock. A snapshot copies
+// only the rosters, so it locks every course shard (in index order) and no
+// student shard.
+class ConcurrentEnrollmentManager {
+private:
+    struct CourseShard {
+        mutex lock;
+        unordered_map<StringId, vector<StringId>> students;                      // courseCode -> dense roster
+        unordered_map<StringId, unordered_map<StringId, size_t>> position;       // courseCode -> studentID -> slot
+    };
+    struct StudentShard {
+        mutex lock;
+        unordered_map<StringId, unordered_set<StringId>> courses;                // studentID -> courseCodes
+    };
+
+    vector<CourseShard> courseShards;
+    vector<StudentShard> studentShards;
+
+public:
+    explicit ConcurrentEnrollmentManager(size_t shardCount = 64)
+        : courseShards(shardCount ? shardCount : 1), studentShards(shardCount ? shardCount : 1) {}
+
+    bool enrollStudent(StringId courseCode, StringId studentID) {
+        CourseShard& cs = courseShards[courseCode % courseShards.size()];
+        StudentShard& ss = studentShards[studentID % studentShards.size()];
+        lock_guard<mutex> courseGuard(cs.lock);
+        auto& roster = cs.students[courseCode];
+        if (!cs.position[courseCode].emplace(studentID, roster.size()).second) return false;
+        roster.push_back(studentID);
+        lock_guard<mutex> studentGuard(ss.lock);
+        ss.courses[studentID].insert(courseCode);
+        return true;
+    }
+
+    bool enrollStudent(const string& courseCode, const string& studentID) {
+        return enrollStudent(stringPool().intern(courseCode), stringPool().intern(studentID));
+    }
+
+    bool dropStudent(StringId courseCode, StringId studentID) {
+        CourseShard& cs = courseShards[courseCode % courseShards.size()];
+        StudentShard& ss = studentShards[studentID % studentShards.size()];
+        lock_guard<mutex> courseGuard(cs.lock);
+        auto positions = cs.position.find(courseCode);
+        if (positions == cs.position.end()) return false;
+        auto pos = positions->second.find(studentID);
+        if (pos == positions->second.end()) return false;
+
+        vector<StringId>& roster = cs.students[courseCode];
+        size_t slot = pos->second;
+        positions->second.erase(pos);
+        if (slot != roster.size() - 1) {
+            roster[slot] = roster.back();
+            positions->second[roster[slot]] = slot;
+        }
+        roster.pop_back();
+
+        lock_guard<mutex> studentGuard(ss.lock);
+        auto courses = ss.courses.find(studentID);
+        courses->second.erase(courseCode);
+        if (courses->second.empty())
+            ss.courses.erase(courses);
+        return true;
+    }
+
+    bool dropStudent(const string& courseCode, const string& studentID) {
+        StringId course = stringPool().find(courseCode);
+        StringId student = stringPool().find(studentID);
+        return course != StringPool::npos && student != StringPool::npos && dropStudent(course, student);
+    }
+
+    int getEnrollmentCount(StringId courseCode) {
+        CourseShard& cs = courseShards[courseCode % courseShards.size()];
+        lock_guard<mutex> guard(cs.lock);
+        auto it = cs.students.find(courseCode);
+        return it != cs.students.end() ? it->second.size() : 0;
+    }
+
+    // Consistent copy of every roster, keyed by course
+    unordered_map<StringId, vector<StringId>> snapshot() {
+        vector<unique_lock<mutex>> locks;
+        for (CourseShard& cs : courseShards) locks.emplace_back(cs.lock);
+        unordered_map<StringId, vector<StringId>> rosters;
+        for (CourseShard& cs : courseShards)
+            for (auto& course : cs.students)
+                if (!course.second.empty()) rosters.insert(course);
+        return rosters;
+    }
+
+    vector<StringId> getCoursesForStudent(StringId studentID) {
+        StudentShard& ss = studentShards[studentID % studentShards.size()];
+        lock_guard<mutex> guard(ss.lock);
+        auto it = ss.courses.find(studentID);
+        if (it == ss.courses.end()) return {};
+        return vector<StringId>(it->second.begin(), it->second.end());
+    }
+};
+
+// WAL record types
+enum LogOp : uint8_t {
+    LogEnroll = 1,      // course, student
+    LogDrop = 2,        // course, student
+    LogGrade = 3,       // student, grade
+    LogAssignSlot = 4   // course, time, room
+};
+
+struct LogRecord {
+    LogOp op;
+    string a, b, c;
+    float grade = 0.0;
+};
+
+// WriteAheadLog Class
+// Append-only log of mutations. Each record is framed as
+// [u32 payload length][u32 CRC-32 of payload][payload], so a torn write at
+// the tail is detected on replay and cut off. Writers append into a shared
+// buffer and then wait for durability; whichever waiter finds no flush in
+// progress writes and fdatasyncs everything buffered so far on behalf of
+// all of them (group commit), so one sync covers many concurrent writers.
+class WriteAheadLog {
+private:
+    int fd = -1;
+    mutex logMutex;
+    condition_variable durable;
+    string pending;
+    uint64_t appendedSeq = 0;
+    uint64_t durableSeq = 0;
+    bool flushing = false;
+    bool failed = false;
+
+    static uint32_t crc32(const char* data, size_t length) {
+        static uint32_t table[256];
+        static once_flag init;
+        call_once(init, [] {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                table[i] = c;
+            }
+        });
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < length; i++)
+            crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    static bool putString(string& out, const string& value) {
+        if (value.size() > 0xFFFF) return false;
+        uint16_t length = value.size();
+        out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.append(value.data(), length);
+        return true;
+    }
+
+    static bool getString(const char*& p, const char* end, string& value) {
+        uint16_t length;
+        if (end - p < (long)sizeof(length)) return false;
+        memcpy(&length, p, sizeof(length));
+        p += sizeof(length);
+        if (end - p < length) return false;
+        value.assign(p, length);
+        p += length;
+        return true;
+    }
+
+public:
+    // Keeps calling write() until everything is written or it fails
+    static bool writeAll(int fd, const char* data, size_t length) {
+        while (length > 0) {
+            long written = ::write(fd, data, length);
+            if (written <= 0) return false;
+            data += written;
+            length -= written;
+        }
+        return true;
+    }
+
+    WriteAheadLog() {}
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+    ~WriteAheadLog() { close(); }
+
+    // Returns an empty string when a field is too long for its 16-bit length
+    static string encode(const LogRecord& record) {
+        string payload(1, static_cast<char>(record.op));
+        bool ok = putString(payload, record.a);
+        if (record.op == LogGrade) {
+            payload.append(reinterpret_cast<const char*>(&record.grade), sizeof(record.grade));
+        } else {
+            ok = ok && putString(payload, record.b);
+            if (record.op == LogAssignSlot) ok = ok && putString(payload, record.c);
+        }
+        if (!ok) return string();
+        uint32_t header[2] = {static_cast<uint32_t>(payload.size()), crc32(payload.data(), payload.size())};
+        return string(reinterpret_cast<const char*>(header), sizeof(header)) + payload;
+    }
+
+    // Calls handler for every intact record in the file and returns the byte
+    // offset just past the last one (anything after it is a torn tail)
+    static size_t replay(const string& path, const function<void(const LogRecord&)>& handler) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) return 0;
+        string data;
+        char chunk[1 << 16];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) data.append(chunk, n);
+        fclose(file);
+
+        size_t offset = 0;
+        LogRecord record;
+        while (data.size() - offset >= 8) {
+            uint32_t header[2];
+            memcpy(header, data.data() + offset, sizeof(header));
+            if (header[0] == 0 || data.size() - offset - 8 < header[0]) break;
+            const char* p = data.data() + offset + 8;
+            const char* end = p + header[0];
+            if (crc32(p, header[0]) != header[1]) break;
+
+            record.op = static_cast<LogOp>(*p++);
+            bool ok = getString(p, end, record.a);
+            if (ok && record.op == LogGrade) {
+                ok = end - p == sizeof(float);
+                if (ok) memcpy(&record.grade, p, sizeof(float));
+            } else if (ok) {
+                ok = getString(p, end, record.b) && (record.op != LogAssignSlot || getString(p, end, record.c));
+            }
+            if (!ok) break;
+            handler(record);
+            offset += 8 + header[0];
+        }
+        return offset;
+    }
+
+    // Opens for appending; validLength cuts off a torn tail found by replay()
+    bool open(const string& path, size_t validLength) {
+        close();
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+        if (fd < 0) return false;
+        if (ftruncate(fd, validLength) != 0 || lseek(fd, validLength, SEEK_SET) < 0) {
+            close();
+            return false;
+        }
+        failed = false;
+        return true;
+    }
+
+    void close() {
+        if (fd >= 0) {
+            sync(append(string()));
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    // Buffers an encoded record and returns its sequence number
+    uint64_t append(const string& encoded) {
+        lock_guard<mutex> guard(logMutex);
+        pending += encoded;
+        return ++appendedSeq;
+    }
+
+    // Blocks until every record up to seq is on disk; false on I/O failure
+    bool sync(uint64_t seq) {
+        unique_lock<mutex> lock(logMutex);
+        while (durableSeq < seq && !failed) {
+            if (flushing) {
+                durable.wait(lock);
+                continue;
+            }
+            flushing = true;
+            string batch;
+            batch.swap(pending);
+            uint64_t upTo = appendedSeq;
+            lock.unlock();
+            bool ok = writeAll(fd, batch.data(), batch.size()) && fdatasync(fd) == 0;
+            lock.lock();
+            flushing = false;
+            if (ok) durableSeq = max(durableSeq, upTo);
+            else failed = true;
+            durable.notify_all();
+        }
+        return durableSeq >= seq;
+    }
+
+    // Empties the log after a checkpoint has captured its effects
+    bool truncate() {
+        unique_lock<mutex> lock(logMutex);
+        durable.wait(lock, [&] { return !flushing; });
+        pending.clear();
+        durableSeq = appendedSeq;
+        return ftruncate(fd, 0) == 0 && lseek(fd, 0, SEEK_SET) == 0 && fdatasync(fd) == 0;
+    }
+};
+
+// DurableRegistry Class
+// Enrollments, grades and timetable slots that survive a crash. Every
+// mutation takes a ticket from its key's stripe and is appended to the
+// write-ahead log, waits for the group commit that makes it durable, and
+// only then is applied in memory, in ticket order. So log order matches
+// apply order for each key, a failed commit is never visible to readers,
+// and writers on the same key still share one sync.
+// checkpoint() writes the whole state to <path>.checkpoint and empties the
+// log; open() replays the checkpoint and then the log. Replaying the log
+// over a newer checkpoint is harmless because the last record for each key
+// decides its final state.
+class DurableRegistry {
+private:
+    static const size_t Stripes = 256;
+
+    string path;
+    WriteAheadLog log;
+    ConcurrentGradeBook grades;
+    ConcurrentEnrollmentManager enrollments;
+    mutex slotMutex;
+    unordered_map<StringId, pair<StringId, StringId>> slots;   // course -> (time, room)
+    shared_mutex checkpointMutex;
+    struct Stripe {
+        mutex lock;
+        condition_variable turn;
+        uint64_t issued = 0;    // tickets handed out, in log order
+        uint64_t applied = 0;   // tickets applied (or dropped after a failed sync)
+    };
+    Stripe stripes[Stripes];
+
+    void apply(const LogRecord& record) {
+        StringPool& pool = stringPool();
+        switch (record.op) {
+        case LogEnroll:
+            enrollments.enrollStudent(pool.intern(record.a), pool.intern(record.b));
+            break;
+        case LogDrop:
+            enrollments.dropStudent(pool.intern(record.a), pool.intern(record.b));
+            break;
+        case LogGrade:
+            grades.addGrade(pool.intern(record.a), record.grade);
+            break;
+        case LogAssignSlot: {
+            lock_guard<mutex> guard(slotMutex);
+            slots[pool.intern(record.a)] = {pool.intern(record.b), pool.intern(record.c)};
+            break;
+        }
+        }
+    }
+
+    bool mutate(const LogRecord& record, StringId key) {
+        string encoded = WriteAheadLog::encode(record);
+        if (encoded.empty()) return false;
+        shared_lock<shared_mutex> noCheckpoint(checkpointMutex);
+        Stripe& stripe = stripes[key % Stripes];
+        uint64_t ticket, seq;
+        {
+            lock_guard<mutex> guard(stripe.lock);
+            ticket = stripe.issued++;
+            seq = log.append(encoded);
+        }
+        bool committed = log.sync(seq);
+        unique_lock<mutex> guard(stripe.lock);
+        stripe.turn.wait(guard, [&] { return stripe.applied == ticket; });
+        if (committed) apply(record);
+        stripe.applied++;
+        stripe.turn.notify_all();
+        return committed;
+    }
+
+public:
+    DurableRegistry() {}
+
+    bool open(const string& logPath) {
+        path = logPath;
+        auto handler = [&](const LogRecord& record) { apply(record); };
+        WriteAheadLog::replay(path + ".checkpoint", handler);
+        size_t valid = WriteAheadLog::replay(path, handler);
+        return log.open(path, valid);
+    }
+
+    bool enrollStudent(const string& courseCode, const string& studentID) {
+        return mutate({LogEnroll, courseCode, studentID, "", 0.0}, stringPool().intern(courseCode));
+    }
+
+    bool dropStudent(const string& courseCode, const string& studentID) {
+        return mutate({LogDrop, courseCode, studentID, "", 0.0}, stringPool().intern(courseCode));
+    }
+
+    bool addGrade(const string& studentID, float grade) {
+        if (!(grade >= 0.0 && grade <= 100.0)) return false;
+        return mutate({LogGrade, studentID, "", "", grade}, stringPool().intern(studentID));
+    }
+
+    bool assignSlot(const string& courseCode, const string& time, const string& room) {
+        return mutate({LogAssignSlot, courseCode, time, room, 0.0}, stringPool().intern(courseCode));
+    }
+
+    // Writes the full state to a fresh checkpoint file, then empties the log
+    bool checkpoint() {
+        unique_lock<shared_mutex> exclusive(checkpointMutex);
+        const StringPool& pool = stringPool();
+        string state;
+        for (auto& entry : grades.snapshot())
+            state += WriteAheadLog::encode({LogGrade, pool.str(entry.first), "", "", entry.second});
+        for (auto& course : enrollments.snapshot())
+            for (StringId student : course.second)
+                state += WriteAheadLog::encode({LogEnroll, pool.str(course.first), pool.str(student), "", 0.0});
+        {
+            lock_guard<mutex> guard(slotMutex);
+            for (auto& slot : slots)
+                state += WriteAheadLog::encode({LogAssignSlot, pool.str(slot.first), pool.str(slot.second.first),
+                                                pool.str(slot.second.second), 0.0});
+        }
+
+        string temp = path + ".checkpoint.tmp";
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        bool ok = WriteAheadLog::writeAll(fd, state.data(), state.size()) && fdatasync(fd) == 0;
+        ::close(fd);
+        if (!ok || rename(temp.c_str(), (path + ".checkpoint").c_str()) != 0) return false;
+
+        // The rename must be durable before the log it replaces is emptied
+        size_t slash = path.find_last_of('/');
+        string directory = slash == string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        int dirFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (dirFd < 0) return false;
+        ok = fsync(dirFd) == 0;
+        ::close(dirFd);
+        return ok && log.truncate();
+    }
+
+    ConcurrentGradeBook& getGrades() { return grades; }
+    ConcurrentEnrollmentManager& getEnrollments() { return enrollments; }
+};
+
+// Times named workloads and writes the results as one JSON document. Each
+// workload runs several times and both the best and the mean time are
+// reported; the checksum returned by the workload is kept so a run that
+// silently does less work shows up as a changed checksum.
+class BenchmarkRunner {
+private:
+    struct Result {
+        string name;
+        size_t operations;
+        double bestSeconds;
+        double meanSeconds;
+        double checksum;
+    };
+
+    string program;
+    uint64_t seed;
+    unsigned repeats;
+    vector<pair<string, size_t>> parameters;
+    vector<Result> results;
+
+public:
+    BenchmarkRunner(const string& program, uint64_t seed, unsigned repeats = 5)
+        : program(program), seed(seed), repeats(max(1u, repeats)) {}
+
+    void parameter(const string& name, size_t value) {
+        parameters.emplace_back(name, value);
+    }
+
+    // setup() runs untimed before every repetition of workload()
+    template <typename Setup, typename Workload>
+    void run(const string& name, size_t operations, Setup setup, Workload workload) {
+        Result result{name, operations, numeric_limits<double>::max(), 0.0, 0.0};
+        for (unsigned r = 0; r < repeats; ++r) {
+            setup();
+            auto start = chrono::steady_clock::now();
+            result.checksum = workload();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            result.bestSeconds = min(result.bestSeconds, seconds);
+            result.meanSeconds += seconds / repeats;
+        }
+        results.push_back(result);
+    }
+
+    template <typename Workload>
+    void run(const string& name, size_t operations, Workload workload) {
+        run(name, operations, [] {}, workload);
+    }
+
+    void writeJson(ostream& out) const {
+        streamsize precision = out.precision(12);
+        out << "{\n  \"program\": \"" << program << "\",\n  \"seed\": " << seed << ",\n  \"repeats\": " << repeats
+            << ",\n  \"parameters\": {";
+        for (size_t i = 0; i < parameters.size(); ++i) {
+            out << (i ? ", " : "") << '"' << parameters[i].first << "\": " << parameters[i].second;
+        }
+        out << "},\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << (i ? "," : "") << "\n    {\"name\": \"" << r.name << "\", \"operations\": " << r.operations
+                << ", \"best_seconds\": " << r.bestSeconds << ", \"mean_seconds\": " << r.meanSeconds
+                << ", \"ops_per_second\": " << (r.bestSeconds > 0 ? r.operations / r.bestSeconds : 0.0)
+                << ", \"checksum\": " << r.checksum << "}";
+        }
+        out << "\n  ]\n}\n";
+        out.precision(precision);
+    }
+};
+
+// Seeded grade and enrollment data for the benchmarks, Zipf-skewed by course
+struct SyntheticRoster {
+    vector<StringId> students;
+    vector<StringId> courses;
+    vector<pair<StringId, StringId>> enrollments;   // (course, student)
+    vector<float> grades;                           // one per student
+
+    SyntheticRoster(size_t studentCount, size_t courseCount, size_t coursesPerStudent, uint64_t seed,
+                    double courseSkew = 1.1) {
+        mt19937_64 rng(seed);
+        auto uniform = [&] { return (rng() >> 11) * 0x1.0p-53; };
+        StringPool& pool = stringPool();
+
+        vector<double> popularity(courseCount);
+        double total = 0.0;
+        for (size_t i = 0; i < courseCount; ++i) {
+            courses.push_back(pool.intern("C" + to_string(100000 + i)));
+            total += 1.0 / pow(i + 1.0, courseSkew);
+            popularity[i] = total;
+        }
+
+        for (size_t i = 0; i < studentCount; ++i) {
+            students.push_back(pool.intern("S" + to_string(10000000 + i)));
+            double bell = uniform() + uniform() + uniform() + uniform() - 2.0;
+            grades.push_back(static_cast<float>(min(100.0, max(0.0, 68.0 + bell * 18.0))));
+
+            vector<size_t> taken;
+            size_t wanted = min(coursesPerStudent, courseCount);
+            for (size_t attempt = 0; taken.size() < wanted && attempt < wanted * 8; ++attempt) {
+                size_t course = lower_bound(popularity.begin(), popularity.end(), uniform() * total) - popularity.begin();
+                course = min(course, courseCount - 1);
+                if (find(taken.begin(), taken.end(), course) != taken.end()) continue;
+                taken.push_back(course);
+                enrollments.emplace_back(courses[course], students.back());
+            }
+        }
+    }
+};
+
+// Runs the grade book, enrollment, transcript, membership bitmap, sharded
+// contention and write-ahead log workloads and prints the results as JSON. Usage: --bench [students] [seed]. The
+// managers' console messages are discarded while the workloads run.
+int runBenchmarks(int argc, char* argv[]) {
+    size_t students = argc > 2 ? stoul(argv[2]) : 100000;
+    uint64_t seed = argc > 3 ? stoull(argv[3]) : 42;
+    size_t courses = max<size_t>(1, students / 25);
+    SyntheticRoster roster(students, courses, 5, seed);
+
+    BenchmarkRunner bench("2assignment", seed);
+    bench.parameter("students", students);
+    bench.parameter("courses", courses);
+    bench.parameter("enrollments", roster.enrollments.size());
+
+    streambuf* console = cout.rdbuf(nullptr);
+    unique_ptr<GradeBook> grades;
+    bench.run("gradebook_add_grade", students, [&] { grades.reset(new GradeBook()); }, [&] {
+        for (size_t i = 0; i < students; ++i) grades->addGrade(roster.students[i], roster.grades[i]);
+        return grades->calculateAverageGrade();
+    });
+    bench.run("gradebook_compute_stats", students, [&] { return grades->computeStats().sum; });
+    bench.run("gradebook_percentiles", 1000, [&] {
+        double total = 0.0;
+        for (int p = 0; p < 1000; ++p) total += grades->getPercentile(p / 10.0f);
+        return total;
+    });
+
+    unique_ptr<EnrollmentManager> enrollment;
+    bench.run("enrollment_enroll", roster.enrollments.size(), [&] { enrollment.reset(new EnrollmentManager()); }, [&] {
+        for (auto& e : roster.enrollments) enrollment->enrollStudent(e.first, e.second);
+        return static_cast<double>(enrollment->getTotalEnrollments());
+    });
+    bench.run("enrollment_drop", roster.enrollments.size(),
+              [&] {
+                  enrollment.reset(new EnrollmentManager());
+                  for (auto& e : roster.enrollments) enrollment->enrollStudent(e.first, e.second);
+              },
+              [&] {
+                  double dropped = 0.0;
+                  for (auto& e : roster.enrollments) dropped += enrollment->dropStudent(e.first, e.second);
+                  return dropped;
+              });
+
+    // Add/drop week: half the roster is enrolled, then a seeded trace of
+    // random adds (60%) and drops (40%) over the whole roster is replayed
+    vector<pair<bool, size_t>> addDropTrace;
+    {
+        mt19937_64 rng(seed);
+        for (size_t i = 0; i < roster.enrollments.size(); ++i)
+            addDropTrace.emplace_back(rng() % 5 < 3, rng() % roster.enrollments.size());
+    }
+    bench.run("enrollment_add_drop_trace", addDropTrace.size(),
+              [&] {
+                  enrollment.reset(new EnrollmentManager());
+                  for (size_t i = 0; i < roster.enrollments.size(); i += 2)
+                      enrollment->enrollStudent(roster.enrollments[i].first, roster.enrollments[i].second);
+              },
+              [&] {
+                  for (auto& op : addDropTrace) {
+                      auto& e = roster.enrollments[op.second];
+                      if (op.first) enrollment->enrollStudent(e.first, e.second);
+                      else enrollment->dropStudent(e.first, e.second);
+                  }
+                  return static_cast<double>(enrollment->getTotalEnrollments());
+              });
+
+    // Registration opening: every enrollment as one batch, 150 seats per course
+    vector<RegistrationRequest> requests;
+    requests.reserve(roster.enrollments.size());
+    for (auto& e : roster.enrollments) requests.push_back({e.first, e.second, RegisterEnroll});
+    bench.run("enrollment_register_batch", requests.size(),
+              [&] {
+                  enrollment.reset(new EnrollmentManager());
+                  for (StringId code : roster.courses) enrollment->setCapacity(code, 150);
+              },
+              [&] {
+                  double seated = 0.0;
+                  for (const RegistrationOutcome& outcome : enrollment->registerBatch(requests))
+                      seated += outcome.status == Enrolled;
+                  return seated;
+              });
+
+    unique_ptr<TranscriptLedger> ledger;
+    bench.run("transcript_close_term", roster.enrollments.size(),
+              [&] {
+                  ledger.reset(new TranscriptLedger());
+                  for (size_t i = 0; i < roster.enrollments.size(); ++i)
+                      ledger->recordGrade(roster.enrollments[i].first, roster.enrollments[i].second,
+                                          roster.grades[i % roster.grades.size()]);
+              },
+              [&] { return static_cast<double>(ledger->closeTerm()); });
+
+    // Bitmap membership index over the full roster: build, pairwise course
+    // intersections across the most popular courses, and co-enrollment
+    enrollment.reset(new EnrollmentManager());
+    for (auto& e : roster.enrollments) enrollment->enrollStudent(e.first, e.second);
+    MembershipMatrix matrix;
+    bench.run("membership_build", roster.enrollments.size(), [&] {
+        matrix.build(*enrollment);
+        return static_cast<double>(matrix.studentsInNoCourse().size());
+    });
+    size_t pairs = min<size_t>(1000, courses);
+    vector<vector<string>> coursePairs;
+    for (size_t i = 0; i < pairs; ++i)
+        coursePairs.push_back({stringPool().str(roster.courses[i]), stringPool().str(roster.courses[(i + 1) % courses])});
+    bench.run("membership_intersect", pairs, [&] {
+        double shared = 0.0;
+        for (const vector<string>& pair : coursePairs) shared += matrix.studentsInAll(pair).size();
+        return shared;
+    });
+    bench.run("membership_co_enrollment", roster.enrollments.size(),
+              [&] { return static_cast<double>(matrix.coEnrollment().size()); });
+
+    // Contention: the same roster split across 1..64 writer threads
+    auto fanOut = [](size_t threads, size_t count, const function<void(size_t)>& work) {
+        vector<thread> workers;
+        for (size_t t = 0; t < threads; ++t)
+            workers.emplace_back([&, t] {
+                for (size_t i = t; i < count; i += threads) work(i);
+            });
+        for (thread& worker : workers) worker.join();
+    };
+    unique_ptr<ConcurrentGradeBook> sharedGrades;
+    unique_ptr<ConcurrentEnrollmentManager> sharedEnrollment;
+    for (size_t threads = 1; threads <= 64; threads *= 2) {
+        string suffix = "_t" + to_string(threads);
+        bench.run("concurrent_add_grade" + suffix, students, [&] { sharedGrades.reset(new ConcurrentGradeBook()); },
+                  [&] {
+                      fanOut(threads, students, [&](size_t i) { sharedGrades->addGrade(roster.students[i], roster.grades[i]); });
+                      return static_cast<double>(sharedGrades->size());
+                  });
+        bench.run("concurrent_enroll" + suffix, roster.enrollments.size(),
+                  [&] { sharedEnrollment.reset(new ConcurrentEnrollmentManager()); },
+                  [&] {
+                      atomic<size_t> enrolled{0};
+                      fanOut(threads, roster.enrollments.size(), [&](size_t i) {
+                          enrolled += sharedEnrollment->enrollStudent(roster.enrollments[i].first, roster.enrollments[i].second);
+                      });
+                      return static_cast<double>(enrolled);
+                  });
+    }
+
+    // Durable enrollments: one writer, so every enrollStudent() pays its own
+    // fdatasync, against many writers sharing group commits. The log lives
+    // next to the binary so the syncs hit a real disk, and is removed after.
+    const size_t durableOps = min<size_t>(roster.enrollments.size(), 20000);
+    string walPath = "bench_" + to_string(getpid()) + ".wal";
+    unique_ptr<DurableRegistry> registry;
+    auto freshRegistry = [&] {
+        registry.reset();
+        remove(walPath.c_str());
+        remove((walPath + ".checkpoint").c_str());
+        registry.reset(new DurableRegistry());
+        registry->open(walPath);
+    };
+    for (size_t writers : {1, 8, 64}) {
+        size_t ops = writers == 1 ? durableOps / 10 : durableOps;
+        bench.run(writers == 1 ? "durable_enroll_sync_per_op" : "durable_enroll_group_commit_t" + to_string(writers),
+                  ops, freshRegistry, [&] {
+                      atomic<size_t> committed{0};
+                      fanOut(writers, ops, [&](size_t i) {
+                          const string& course = stringPool().str(roster.enrollments[i].first);
+                          const string& student = stringPool().str(roster.enrollments[i].second);
+                          committed += registry->enrollStudent(course, student);
+                      });
+                      return static_cast<double>(committed);
+                  });
+    }
+    registry.reset();
+    remove(walPath.c_str());
+    remove((walPath + ".checkpoint").c_str());
+    cout.rdbuf(console);
+
+    bench.writeJson(cout);
+    return 0;
+}
+
 // Test function to demonstrate polymorphism
 void testPayment(Person* person) {
     cout << "Payment for " << person->getName() << ": " << person->calculatePayment() << endl;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") return runBenchmarks(argc, argv);
+
+    // Latency metrics are only written out when asked for: --metrics PATH
+    string metricsPath;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (string(argv[i]) == "--metrics") metricsPath = argv[++i];
+    }
+
     // Create an array of Person pointers containing both Student and Professor objects
     Person* people[3];
     people[0] = new Student("Alice", 20, "S1234", "9876543210", "2021-08-15", "Computer Science", 3.8);
@@ -234,5 +2271,6 @@ int main() {
         delete people[i];
     }
 
+    if (!metricsPath.empty()) metrics().dump(metricsPath);
     return 0;
 }
\ No newline at end of file
@@ -2,23 +2,553 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <deque>
 #include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <tuple>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <variant>
+#include <charconv>
+#include <cstdio>
+#include <functional>
+#include <cmath>
+#include <cerrno>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <mutex>
 using namespace std;
 
+// Operations timed by METRIC_TIMER
+enum MetricOp 
+{
+    MetricAssignSlot,
+    MetricPayrollTotal,
+    MetricPayrollRun,
+    MetricOpCount
+};
+
+const char* const metricOpNames[MetricOpCount] = {"schedule_assign_slot", "payroll_total", "payroll_engine_run"};
+
+// Reduced copy of the registry in 2assignment.cpp (each assignment builds
+// as its own program): per-thread shards of power-of-two latency buckets,
+// merged only when written out. -DNO_METRICS compiles the timers out.
+class MetricsRegistry 
+{
+    static constexpr size_t Buckets = 64;   // bucket i counts latencies below 2^i ns
+
+    struct Shard 
+    {
+        atomic<uint64_t> counts[MetricOpCount][Buckets];
+        atomic<uint64_t> totals[MetricOpCount];
+    };
+
+    mutex shardsMutex;
+    vector<unique_ptr<Shard>> shards;
+
+    Shard& localShard() 
+    {
+        thread_local Shard* shard = nullptr;
+        if (!shard) 
+        {
+            lock_guard<mutex> guard(shardsMutex);
+            shards.emplace_back(new Shard());   // value-initialized: all zero
+            shard = shards.back().get();
+        }
+        return *shard;
+    }
+
+    // Only the owning thread writes a shard, so load + store is enough
+    static void bump(atomic<uint64_t>& counter, uint64_t by) 
+    {
+        counter.store(counter.load(memory_order_relaxed) + by, memory_order_relaxed);
+    }
+
+public:
+    void record(MetricOp op, uint64_t nanos) 
+    {
+        Shard& shard = localShard();
+        size_t bucket = nanos ? min<size_t>(Buckets - 1, 64 - __builtin_clzll(nanos)) : 0;
+        bump(shard.counts[op][bucket], 1);
+        bump(shard.totals[op], nanos);
+    }
+
+    // Prometheus text exposition format, one histogram per operation
+    void writePrometheus(ostream& out) 
+    {
+        out << "# HELP university_op_seconds Latency of instrumented operations.\n";
+        out << "# TYPE university_op_seconds histogram\n";
+        lock_guard<mutex> guard(shardsMutex);
+        for (int op = 0; op < MetricOpCount; ++op) 
+        {
+            string label = string("op=\"") + metricOpNames[op] + "\"";
+            uint64_t cumulative = 0, totalNanos = 0;
+            for (size_t i = 0; i < Buckets; ++i) 
+            {
+                uint64_t n = 0;
+                for (const unique_ptr<Shard>& shard : shards) 
+                {
+                    n += shard->counts[op][i].load(memory_order_relaxed);
+                }
+                cumulative += n;
+                if (n && i + 1 < Buckets) 
+                {
+                    out << "university_op_seconds_bucket{" << label << ",le=\"" << ldexp(1.0, int(i)) * 1e-9 << "\"} "
+                        << cumulative << '\n';
+                }
+            }
+            for (const unique_ptr<Shard>& shard : shards) 
+            {
+                totalNanos += shard->totals[op].load(memory_order_relaxed);
+            }
+            out << "university_op_seconds_bucket{" << label << ",le=\"+Inf\"} " << cumulative << '\n';
+            out << "university_op_seconds_sum{" << label << "} " << totalNanos * 1e-9 << '\n';
+            out << "university_op_seconds_count{" << label << "} " << cumulative << '\n';
+        }
+    }
+
+    // Writes the Prometheus text to a file for scraping or offline analysis
+    bool dump(const string& path) 
+    {
+        ofstream file(path, ios::trunc);
+        writePrometheus(file);
+        return static_cast<bool>(file);
+    }
+};
+
+MetricsRegistry& metrics() 
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+// Records the lifetime of the enclosing scope under one operation
+class MetricTimer 
+{
+    MetricOp op;
+    chrono::steady_clock::time_point start;
+public:
+    explicit MetricTimer(MetricOp op) : op(op), start(chrono::steady_clock::now()) {}
+
+    ~MetricTimer() 
+    {
+        auto elapsed = chrono::steady_clock::now() - start;
+        metrics().record(op, chrono::duration_cast<chrono::nanoseconds>(elapsed).count());
+    }
+};
+
+#ifdef NO_METRICS
+#define METRIC_TIMER(op) ((void)0)
+#else
+#define METRIC_TIMER(op) MetricTimer metricTimer(op)
+#endif
+
+class SnapshotWriter;
+
+// Calendar date packed into 32 bits (year << 9 | month << 5 | day): no heap
+// storage, and dates compare as plain integers. Built from and printed as
+// ISO "YYYY-MM-DD". The empty Date (from "") means missing and prints as "".
+// Text that is not a real ISO date is kept verbatim in a process-wide table
+// and the Date holds its index with the top bit set, so it still prints as
+// written and never equals or falls inside a range of real dates.
+class Date 
+{
+    static constexpr uint32_t Unparsed = 0x80000000;
+
+    uint32_t packed = 0;
+
+    static bool digits(string_view text, int& value) 
+    {
+        return from_chars(text.data(), text.data() + text.size(), value).ptr == text.data() + text.size();
+    }
+
+    // A deque, so views into earlier entries survive later additions
+    static deque<string>& unparsedTexts() 
+    {
+        static deque<string> texts;
+        return texts;
+    }
+
+    static mutex& unparsedMutex() 
+    {
+        static mutex lock;
+        return lock;
+    }
+
+public:
+    Date() {}
+    Date(int year, int month, int day) : packed(uint32_t(year) << 9 | uint32_t(month) << 5 | uint32_t(day)) {}
+    Date(const char* iso) : Date(parse(iso)) {}
+    Date(const string& iso) : Date(parse(iso)) {}
+
+    static Date parse(string_view iso) 
+    {
+        static const int monthDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        if (iso.empty()) 
+        {
+            return Date();
+        }
+        int year, month, day;
+        if (iso.size() == 10 && iso[4] == '-' && iso[7] == '-' && digits(iso.substr(0, 4), year) &&
+            digits(iso.substr(5, 2), month) && digits(iso.substr(8, 2), day) && month >= 1 && month <= 12 &&
+            day >= 1 && day <= monthDays[month - 1] + (month == 2 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0))) 
+        {
+            return Date(year, month, day);
+        }
+        lock_guard<mutex> guard(unparsedMutex());
+        Date unparsed;
+        unparsed.packed = Unparsed | uint32_t(unparsedTexts().size());
+        unparsedTexts().emplace_back(iso);
+        return unparsed;
+    }
+
+    int year() const 
+    {
+         return packed >> 9; 
+    }
+    int month() const 
+    {
+         return (packed >> 5) & 15; 
+    }
+    int day() const 
+    {
+         return packed & 31; 
+    }
+    bool empty() const 
+    {
+         return packed == 0; 
+    }
+    // Built from text that is not a real ISO date
+    bool unparsed() const 
+    {
+         return (packed & Unparsed) != 0; 
+    }
+
+    // Writes the ISO text into out (at least 10 chars); returns its length,
+    // which is 0 for the empty Date and for unparsed text
+    size_t format(char* out) const 
+    {
+        if (empty() || unparsed()) 
+        {
+            return 0;
+        }
+        const int parts[] = {year() / 100, year() % 100, month(), day()};
+        char* p = out;
+        for (int i = 0; i < 4; ++i) 
+        {
+            if (i >= 2) 
+            {
+                *p++ = '-';
+            }
+            *p++ = char('0' + parts[i] / 10 % 10);
+            *p++ = char('0' + parts[i] % 10);
+        }
+        return 10;
+    }
+
+    // The date as text: ISO written into buffer (at least 10 chars), or
+    // the original text of an unparsed Date
+    string_view text(char* buffer) const 
+    {
+        if (unparsed()) 
+        {
+            lock_guard<mutex> guard(unparsedMutex());
+            return unparsedTexts()[packed & ~Unparsed];
+        }
+        return string_view(buffer, format(buffer));
+    }
+
+    string toString() const 
+    {
+        char buffer[11];
+        return string(text(buffer));
+    }
+
+    friend bool operator==(Date a, Date b) 
+    {
+         return a.packed == b.packed; 
+    }
+    friend bool operator!=(Date a, Date b) 
+    {
+         return a.packed != b.packed; 
+    }
+    friend bool operator<(Date a, Date b) 
+    {
+         return a.packed < b.packed; 
+    }
+    friend bool operator>(Date a, Date b) 
+    {
+         return a.packed > b.packed; 
+    }
+
+    friend ostream& operator<<(ostream& out, Date date) 
+    {
+        char buffer[11];
+        return out << date.text(buffer);
+    }
+};
+
+enum ReportFormat 
+{
+    TextReport,
+    CsvReport,
+    JsonReport
+};
+
+// Renders records of named fields as text, CSV or JSON into one large
+// reusable buffer and hands it to the sink only when the buffer is full
+// (or on flush), instead of flushing the stream on every line. Numbers are
+// formatted with to_chars. In CSV a header row is written whenever a record
+// has different field names from the one before, so a mixed roster comes
+// out as one block per role.
+class ReportWriter 
+{
+    ostream& sink;
+    ReportFormat format;
+    size_t capacity;
+    string buffer;
+    vector<string_view> names;      // field names of the current record
+    vector<string_view> lastNames;  // field names of the previous CSV record
+    size_t recordStart = 0;
+    size_t records = 0;
+
+    void appendEscaped(string_view value) 
+    {
+        if (format == JsonReport) 
+        {
+            buffer += '"';
+            for (char c : value) 
+            {
+                if (c == '"' || c == '\\') 
+                {
+                    buffer += '\\';
+                    buffer += c;
+                }
+                else if (static_cast<unsigned char>(c) < 0x20) 
+                {
+                    char code[8];
+                    snprintf(code, sizeof(code), "\\u%04x", c);
+                    buffer += code;
+                }
+                else 
+                {
+                    buffer += c;
+                }
+            }
+            buffer += '"';
+        }
+        else if (format == CsvReport && value.find_first_of(",\"\r\n") != string_view::npos) 
+        {
+            buffer += '"';
+            for (char c : value) 
+            {
+                if (c == '"') 
+                {
+                    buffer += '"';
+                }
+                buffer += c;
+            }
+            buffer += '"';
+        }
+        else 
+        {
+            buffer.append(value.data(), value.size());
+        }
+    }
+
+    void appendRaw(string_view name, const char* text, size_t length) 
+    {
+        separator(name);
+        buffer.append(text, length);
+    }
+
+    void separator(string_view name) 
+    {
+        if (!names.empty()) 
+        {
+            buffer += format == TextReport ? ", " : ",";
+        }
+        names.push_back(name);
+        if (format == TextReport) 
+        {
+            buffer.append(name.data(), name.size());
+            buffer += ": ";
+        }
+        else if (format == JsonReport) 
+        {
+            appendEscaped(name);
+            buffer += ':';
+        }
+    }
+
+public:
+    ReportWriter(ostream& sink, ReportFormat format = TextReport, size_t capacity = 1 << 20)
+        : sink(sink), format(format), capacity(capacity) 
+    {
+        buffer.reserve(capacity + 4096);
+        if (format == JsonReport) 
+        {
+            buffer += '[';
+        }
+    }
+
+    ~ReportWriter() 
+    {
+         finish(); 
+    }
+
+    void beginRecord() 
+    {
+        names.clear();
+        recordStart = buffer.size();
+        if (format == JsonReport) 
+        {
+            buffer += records ? ",\n{" : "\n{";
+        }
+    }
+
+    void field(string_view name, string_view value) 
+    {
+        separator(name);
+        appendEscaped(value);
+    }
+
+    void field(string_view name, const char* value) 
+    {
+         field(name, string_view(value)); 
+    }
+
+    void field(string_view name, const string& value) 
+    {
+         field(name, string_view(value)); 
+    }
+
+    void field(string_view name, Date value) 
+    {
+        char text[11];
+        field(name, value.text(text));
+    }
+
+    void field(string_view name, int value) 
+    {
+        char text[16];
+        auto result = to_chars(text, text + sizeof(text), value);
+        appendRaw(name, text, result.ptr - text);
+    }
+
+    void field(string_view name, float value) 
+    {
+        char text[32];
+        auto result = to_chars(text, text + sizeof(text), value);
+        appendRaw(name, text, result.ptr - text);
+    }
+
+    void endRecord() 
+    {
+        if (format == JsonReport) 
+        {
+            buffer += '}';
+        }
+        else 
+        {
+            buffer += '\n';
+        }
+        if (format == CsvReport && names != lastNames) 
+        {
+            string header;
+            for (size_t i = 0; i < names.size(); ++i) 
+            {
+                header += i ? "," : "";
+                header.append(names[i].data(), names[i].size());
+            }
+            header += '\n';
+            buffer.insert(recordStart, header);
+            lastNames = names;
+        }
+        ++records;
+        if (buffer.size() >= capacity) 
+        {
+            flush();
+        }
+    }
+
+    void flush() 
+    {
+        sink.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+    // Closes the JSON array and writes out everything buffered
+    void finish() 
+    {
+        if (format == JsonReport) 
+        {
+            buffer += records ? "\n]\n" : "]\n";
+            format = TextReport;   // finish only once
+        }
+        flush();
+        sink.flush();
+    }
+};
+
 class Person 
 {
+    friend class SnapshotWriter;
 protected:
     string name, id, contact;
     int age;
 
 public:
+    // Text parameters are sinks: pass temporaries (or std::move) and each
+    // string is built once, straight into its member.
     Person(string name, int age, string id, string contact)
-        : name(name), age(age), id(id), contact(contact) {}
+        : name(std::move(name)), id(std::move(id)), contact(std::move(contact)), age(age) {}
     virtual ~Person() {}
 
     virtual void displayDetails() const 
     {
-        cout << "Name: " << name << ", Age: " << age << ", ID: " << id << ", Contact: " << contact << endl;
+        cout << "Name: " << name << ", Age: " << age << ", ID: " << id << ", Contact: " << contact << '\n';
+    }
+
+    const string& getName() const 
+    {
+         return name; 
+    }
+    const string& getID() const 
+    {
+         return id; 
+    }
+
+    // Writes this person's fields into the current report record
+    virtual void renderFields(ReportWriter& report) const 
+    {
+        report.field("name", name);
+        report.field("age", age);
+        report.field("id", id);
+        report.field("contact", contact);
+    }
+
+    void render(ReportWriter& report) const 
+    {
+        report.beginRecord();
+        renderFields(report);
+        report.endRecord();
     }
 
     virtual float calculatePayment() const 
@@ -29,24 +559,43 @@ public:
 
 class Student : public Person 
 {
+    friend class SnapshotWriter;
 protected:
-    string enrollment_date, program;
+    Date enrollment_date;
+    string program;
     float GPA;
     vector<class Course*> courses;
 
 public:
-    Student(string name, int age, string id, string contact, string enrollment_date, string program, float GPA)
-        : Person(name, age, id, contact), enrollment_date(enrollment_date), program(program), GPA(GPA) {}
+    Student(string name, int age, string id, string contact, Date enrollment_date, string program, float GPA)
+        : Person(std::move(name), age, std::move(id), std::move(contact)), enrollment_date(enrollment_date),
+          program(std::move(program)), GPA(GPA) {}
 
     void enrollInCourse(class Course* course) 
     {
          courses.push_back(course); 
     }
+    const vector<class Course*>& getCourses() const 
+    {
+         return courses; 
+    }
+    const string& getProgram() const 
+    {
+         return program; 
+    }
 
     void displayDetails() const override 
     {
         Person::displayDetails();
-        cout << "Enrollment: " << enrollment_date << ", Program: " << program << ", GPA: " << GPA << endl;
+        cout << "Enrollment: " << enrollment_date << ", Program: " << program << ", GPA: " << GPA << '\n';
+    }
+
+    void renderFields(ReportWriter& report) const override 
+    {
+        Person::renderFields(report);
+        report.field("enrollment_date", enrollment_date);
+        report.field("program", program);
+        report.field("gpa", GPA);
     }
 
     float calculatePayment() const override 
@@ -57,33 +606,56 @@ public:
 
 class UndergraduateStudent : public Student 
 {
-    string major, minor, graduation_date;
+    friend class SnapshotWriter;
+    string major, minor;
+    Date graduation_date;
 public:
-    UndergraduateStudent(string name, int age, string id, string contact, string enrollment_date, string program, float GPA,
-                         string major, string minor, string graduation_date)
-        : Student(name, age, id, contact, enrollment_date, program, GPA), major(major), minor(minor), graduation_date(graduation_date) {}
+    UndergraduateStudent(string name, int age, string id, string contact, Date enrollment_date, string program, float GPA,
+                         string major, string minor, Date graduation_date)
+        : Student(std::move(name), age, std::move(id), std::move(contact), enrollment_date, std::move(program), GPA),
+          major(std::move(major)), minor(std::move(minor)), graduation_date(graduation_date) {}
 
     void displayDetails() const override 
     {
         Student::displayDetails();
-        cout << "Major: " << major << ", Minor: " << minor << ", Graduation: " << graduation_date << endl;
+        cout << "Major: " << major << ", Minor: " << minor << ", Graduation: " << graduation_date << '\n';
+    }
+
+    void renderFields(ReportWriter& report) const override 
+    {
+        Student::renderFields(report);
+        report.field("major", major);
+        report.field("minor", minor);
+        report.field("graduation_date", graduation_date);
     }
 };
 
 class GraduateStudent : public Student 
 {
+    friend class SnapshotWriter;
     string research_topic, advisor, thesis_title;
     int teaching_assist_hours = 0;
     int research_assist_hours = 0;
 public:
-    GraduateStudent(string name, int age, string id, string contact, string enrollment_date, string program, float GPA,
+    GraduateStudent(string name, int age, string id, string contact, Date enrollment_date, string program, float GPA,
                     string research_topic, string advisor, string thesis_title)
-        : Student(name, age, id, contact, enrollment_date, program, GPA), research_topic(research_topic), advisor(advisor), thesis_title(thesis_title) {}
+        : Student(std::move(name), age, std::move(id), std::move(contact), enrollment_date, std::move(program), GPA),
+          research_topic(std::move(research_topic)), advisor(std::move(advisor)), thesis_title(std::move(thesis_title)) {}
 
     void displayDetails() const override 
     {
         Student::displayDetails();
-        cout << "Research Topic: " << research_topic << ", Advisor: " << advisor << ", Thesis: " << thesis_title << endl;
+        cout << "Research Topic: " << research_topic << ", Advisor: " << advisor << ", Thesis: " << thesis_title << '\n';
+    }
+
+    void renderFields(ReportWriter& report) const override 
+    {
+        Student::renderFields(report);
+        report.field("research_topic", research_topic);
+        report.field("advisor", advisor);
+        report.field("thesis_title", thesis_title);
+        report.field("teaching_assist_hours", teaching_assist_hours);
+        report.field("research_assist_hours", research_assist_hours);
     }
 
     void addTeachingHours(int hours) 
@@ -94,31 +666,113 @@ public:
     {
          research_assist_hours += hours; 
     }
+    const string& getAdvisor() const 
+    {
+         return advisor; 
+    }
+    int getTeachingHours() const 
+    {
+         return teaching_assist_hours; 
+    }
+    int getResearchHours() const 
+    {
+         return research_assist_hours; 
+    }
 
-    float calculatePayment() const override 
+    static float pay(int teaching_assist_hours, int research_assist_hours) 
     {
         return 1500.0 + teaching_assist_hours * 20 + research_assist_hours * 25;
     }
+
+    float calculatePayment() const override 
+    {
+        return pay(teaching_assist_hours, research_assist_hours);
+    }
 };
 
 class Professor : public Person 
 {
+    friend class SnapshotWriter;
 protected:
-    string department, specialization, hire_date;
+    string department, specialization;
+    Date hire_date;
     int years_of_service;
     float base_salary;
     float research_grants;
 
 public:
     Professor(string name, int age, string id, string contact, string department,
-              string specialization, string hire_date, int years, float base_salary, float grants)
-        : Person(name, age, id, contact), department(department), specialization(specialization),
+              string specialization, Date hire_date, int years, float base_salary, float grants)
+        : Person(std::move(name), age, std::move(id), std::move(contact)), department(std::move(department)),
+          specialization(std::move(specialization)),
           hire_date(hire_date), years_of_service(years), base_salary(base_salary), research_grants(grants) {}
 
+    const string& getDepartment() const 
+    {
+         return department; 
+    }
+    const string& getSpecialization() const 
+    {
+         return specialization; 
+    }
+    Date getHireDate() const 
+    {
+         return hire_date; 
+    }
+    int getYearsOfService() const 
+    {
+         return years_of_service; 
+    }
+    float getBaseSalary() const 
+    {
+         return base_salary; 
+    }
+    float getResearchGrants() const 
+    {
+         return research_grants; 
+    }
+
     void displayDetails() const override 
     {
         Person::displayDetails();
-        cout << "Dept: " << department << ", Spec: " << specialization << ", Hire Date: " << hire_date << endl;
+        cout << "Dept: " << department << ", Spec: " << specialization << ", Hire Date: " << hire_date << '\n';
+    }
+
+    void renderFields(ReportWriter& report) const override 
+    {
+        Person::renderFields(report);
+        report.field("department", department);
+        report.field("specialization", specialization);
+        report.field("hire_date", hire_date);
+        report.field("years_of_service", years_of_service);
+        report.field("base_salary", base_salary);
+        report.field("research_grants", research_grants);
+    }
+};
+
+// Pay rules per professor rank, shared by the virtual classes below and
+// by the statically dispatched payroll types further down.
+struct AssistantRank 
+{
+    static float pay(float base_salary, int years_of_service, float research_grants) 
+    {
+        return base_salary + years_of_service * 300 + research_grants;
+    }
+};
+
+struct AssociateRank 
+{
+    static float pay(float base_salary, int years_of_service, float research_grants) 
+    {
+        return base_salary + years_of_service * 500 + research_grants * 1.2;
+    }
+};
+
+struct FullRank 
+{
+    static float pay(float base_salary, int years_of_service, float research_grants) 
+    {
+        return base_salary + years_of_service * 800 + research_grants * 1.5;
     }
 };
 
@@ -126,12 +780,13 @@ class AssistantProfessor : public Professor
 {
 public:
     AssistantProfessor(string name, int age, string id, string contact, string department,
-                       string specialization, string hire_date, int years, float salary, float grants)
-        : Professor(name, age, id, contact, department, specialization, hire_date, years, salary, grants) {}
+                       string specialization, Date hire_date, int years, float salary, float grants)
+        : Professor(std::move(name), age, std::move(id), std::move(contact), std::move(department),
+                    std::move(specialization), hire_date, years, salary, grants) {}
 
     float calculatePayment() const override 
     {
-        return base_salary + years_of_service * 300 + research_grants;
+        return AssistantRank::pay(base_salary, years_of_service, research_grants);
     }
 };
 
@@ -139,12 +794,13 @@ class AssociateProfessor : public Professor
 {
 public:
     AssociateProfessor(string name, int age, string id, string contact, string department,
-                       string specialization, string hire_date, int years, float salary, float grants)
-        : Professor(name, age, id, contact, department, specialization, hire_date, years, salary, grants) {}
+                       string specialization, Date hire_date, int years, float salary, float grants)
+        : Professor(std::move(name), age, std::move(id), std::move(contact), std::move(department),
+                    std::move(specialization), hire_date, years, salary, grants) {}
 
     float calculatePayment() const override 
     {
-        return base_salary + years_of_service * 500 + research_grants * 1.2;
+        return AssociateRank::pay(base_salary, years_of_service, research_grants);
     }
 };
 
@@ -152,12 +808,13 @@ class FullProfessor : public Professor
 {
 public:
     FullProfessor(string name, int age, string id, string contact, string department,
-                  string specialization, string hire_date, int years, float salary, float grants)
-        : Professor(name, age, id, contact, department, specialization, hire_date, years, salary, grants) {}
+                  string specialization, Date hire_date, int years, float salary, float grants)
+        : Professor(std::move(name), age, std::move(id), std::move(contact), std::move(department),
+                    std::move(specialization), hire_date, years, salary, grants) {}
 
     float calculatePayment() const override 
     {
-        return base_salary + years_of_service * 800 + research_grants * 1.5;
+        return FullRank::pay(base_salary, years_of_service, research_grants);
     }
 };
 
@@ -166,8 +823,8 @@ class Course
     string courseCode;
     Professor* instructor;
 public:
-    Course(string code, Professor* prof) : courseCode(code), instructor(prof) {}
-    string getCode() const 
+    Course(string code, Professor* prof) : courseCode(std::move(code)), instructor(prof) {}
+    const string& getCode() const 
     {
          return courseCode; 
     }
@@ -182,16 +839,16 @@ class Department
     string name;
     vector<Professor*> professors;
 public:
-    Department(string name) : name(name) {}
+    Department(string name) : name(std::move(name)) {}
     void addProfessor(Professor* prof) 
     {
          professors.push_back(prof); 
     }
-    vector<Professor*> getProfessors() const 
+    const vector<Professor*>& getProfessors() const 
     {
          return professors; 
     }
-    string getName() const 
+    const string& getName() const 
     {
          return name; 
     }
@@ -201,20 +858,341 @@ class Classroom
 {
     string roomNumber;
 public:
-    Classroom(string room) : roomNumber(room) {}
-    string getRoomNumber() const 
+    Classroom(string room) : roomNumber(std::move(room)) {}
+    const string& getRoomNumber() const 
     {
          return roomNumber; 
     }
 };
 
-class Schedule 
+// Half-open range of minutes since Monday 00:00
+struct TimeInterval 
 {
-    map<Course*, pair<string, Classroom*>> timetable;
-public:
-    void assignSlot(Course* course, string time, Classroom* room) 
+    int start = 0;
+    int end = 0;
+
+    bool overlaps(const TimeInterval& other) const 
     {
+         return start < other.end && other.start < end; 
+    }
+};
+
+// Parses "Mon 10:00" (one hour) or "Mon 10:00-11:30" into a TimeInterval
+bool parseTimeSlot(const string& text, TimeInterval& interval) 
+{
+    static const char* days[] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+    if (text.size() < 9 || text[3] != ' ') 
+    {
+        return false;
+    }
+    int day = -1;
+    for (int d = 0; d < 7; ++d) 
+    {
+        if (text.compare(0, 3, days[d]) == 0) 
+        {
+            day = d;
+        }
+    }
+    auto clock = [&](size_t pos, int& minutes) 
+    {
+        if (pos + 5 > text.size() || text[pos + 2] != ':') 
+        {
+            return false;
+        }
+        for (size_t i : {pos, pos + 1, pos + 3, pos + 4}) 
+        {
+            if (text[i] < '0' || text[i] > '9') 
+            {
+                return false;
+            }
+        }
+        int hours = (text[pos] - '0') * 10 + (text[pos + 1] - '0');
+        int mins = (text[pos + 3] - '0') * 10 + (text[pos + 4] - '0');
+        minutes = hours * 60 + mins;
+        return hours < 24 && mins < 60;
+    };
+    int from, to;
+    if (day < 0 || !clock(4, from)) 
+    {
+        return false;
+    }
+    if (text.size() == 9) 
+    {
+        to = from + 60;
+    }
+    else if (text.size() != 15 || text[9] != '-' || !clock(10, to) || to <= from) 
+    {
+        return false;
+    }
+    interval.start = day * 24 * 60 + from;
+    interval.end = day * 24 * 60 + to;
+    return true;
+}
+
+// Booked intervals of one room, instructor or student. Bookings never
+// overlap, so ordering them by start time lets an overlap check look only
+// at the neighbours of the new interval: O(log n).
+class IntervalCalendar 
+{
+    map<int, pair<int, Course*>> bookings;   // start -> (end, course)
+public:
+    Course* findOverlap(const TimeInterval& interval) const 
+    {
+        auto next = bookings.lower_bound(interval.start);
+        if (next != bookings.end() && next->first < interval.end) 
+        {
+            return next->second.second;
+        }
+        if (next != bookings.begin()) 
+        {
+            auto prev = std::prev(next);
+            if (prev->second.first > interval.start) 
+            {
+                return prev->second.second;
+            }
+        }
+        return nullptr;
+    }
+    void book(const TimeInterval& interval, Course* course) 
+    {
+         bookings[interval.start] = {interval.end, course}; 
+    }
+    void release(const TimeInterval& interval) 
+    {
+         bookings.erase(interval.start); 
+    }
+    bool empty() const 
+    {
+         return bookings.empty(); 
+    }
+};
+
+enum ConflictKind 
+{
+    NoConflict,
+    InvalidTime,
+    RoomClash,
+    InstructorClash,
+    StudentClash
+};
+
+struct ScheduleConflict 
+{
+    ConflictKind kind = NoConflict;
+    Course* with = nullptr;      // already-scheduled course that clashes
+    const Student* student = nullptr;  // set for StudentClash
+
+    explicit operator bool() const 
+    {
+         return kind != NoConflict; 
+    }
+};
+
+struct SlotRequest 
+{
+    Course* course;
+    string time;
+    Classroom* room;
+};
+
+class Schedule 
+{
+    friend class SnapshotWriter;
+    map<Course*, pair<string, Classroom*>> timetable;
+    unordered_map<Course*, TimeInterval> intervals;
+    unordered_map<const Classroom*, IntervalCalendar> roomCalendars;
+    unordered_map<const Professor*, IntervalCalendar> instructorCalendars;
+    unordered_map<const Student*, IntervalCalendar> studentCalendars;
+    unordered_map<const Course*, vector<const Student*>> courseStudents;
+    unordered_map<const Student*, vector<const Course*>> studentCourses;   // registrations, a few per student
+
+    ScheduleConflict check(Course* course, const TimeInterval& interval, Classroom* room) const 
+    {
+        ScheduleConflict conflict;
+        auto calendarClash = [&](const auto& calendars, const auto* owner, ConflictKind kind) 
+        {
+            auto it = calendars.find(owner);
+            if (it != calendars.end()) 
+            {
+                conflict.with = it->second.findOverlap(interval);
+                if (conflict.with) 
+                {
+                    conflict.kind = kind;
+                }
+            }
+            return conflict.with != nullptr;
+        };
+        if (room && calendarClash(roomCalendars, room, RoomClash)) 
+        {
+            return conflict;
+        }
+        if (course->getInstructor() && calendarClash(instructorCalendars, course->getInstructor(), InstructorClash)) 
+        {
+            return conflict;
+        }
+        auto students = courseStudents.find(course);
+        if (students != courseStudents.end()) 
+        {
+            for (const Student* student : students->second) 
+            {
+                if (calendarClash(studentCalendars, student, StudentClash)) 
+                {
+                    conflict.student = student;
+                    return conflict;
+                }
+            }
+        }
+        return conflict;
+    }
+
+    void book(Course* course, const TimeInterval& interval, Classroom* room) 
+    {
+        intervals[course] = interval;
+        if (room) 
+        {
+            roomCalendars[room].book(interval, course);
+        }
+        if (course->getInstructor()) 
+        {
+            instructorCalendars[course->getInstructor()].book(interval, course);
+        }
+        auto students = courseStudents.find(course);
+        if (students != courseStudents.end()) 
+        {
+            for (const Student* student : students->second) 
+            {
+                studentCalendars[student].book(interval, course);
+            }
+        }
+    }
+
+    void release(Course* course) 
+    {
+        auto it = intervals.find(course);
+        if (it == intervals.end()) 
+        {
+            return;
+        }
+        Classroom* room = timetable[course].second;
+        if (room) 
+        {
+            roomCalendars[room].release(it->second);
+        }
+        if (course->getInstructor()) 
+        {
+            instructorCalendars[course->getInstructor()].release(it->second);
+        }
+        auto students = courseStudents.find(course);
+        if (students != courseStudents.end()) 
+        {
+            for (const Student* student : students->second) 
+            {
+                studentCalendars[student].release(it->second);
+            }
+        }
+        intervals.erase(it);
+    }
+
+public:
+    // Makes the schedule check this student's courses for double-booking.
+    // Courses that already have a slot are booked into the student's
+    // calendar straight away; if two of them overlap, the clash is
+    // returned and the schedule is left unchanged. Calling it again after
+    // the student enrolls elsewhere only registers the new courses.
+    ScheduleConflict addStudent(const Student* student) 
+    {
+        ScheduleConflict conflict;
+        auto existing = studentCalendars.find(student);
+        IntervalCalendar calendar = existing != studentCalendars.end() ? existing->second : IntervalCalendar();
+        vector<const Course*>& registered = studentCourses[student];
+        vector<Course*> joining;
+        for (Course* course : student->getCourses()) 
+        {
+            if (find(registered.begin(), registered.end(), course) != registered.end() ||
+                find(joining.begin(), joining.end(), course) != joining.end()) 
+            {
+                continue;   // already registered for this course
+            }
+            auto scheduled = intervals.find(course);
+            if (scheduled != intervals.end()) 
+            {
+                Course* clash = calendar.findOverlap(scheduled->second);
+                if (clash) 
+                {
+                    conflict.kind = StudentClash;
+                    conflict.with = clash;
+                    conflict.student = student;
+                    return conflict;
+                }
+                calendar.book(scheduled->second, course);
+            }
+            joining.push_back(course);
+        }
+        for (Course* course : joining) 
+        {
+            courseStudents[course].push_back(student);
+            registered.push_back(course);
+        }
+        studentCalendars[student] = std::move(calendar);
+        return conflict;
+    }
+
+    // Books the slot unless it clashes with the room, the instructor or an
+    // enrolled student; on a clash the schedule is left unchanged.
+    ScheduleConflict assignSlot(Course* course, string time, Classroom* room) 
+    {
+        METRIC_TIMER(MetricAssignSlot);
+        ScheduleConflict conflict;
+        TimeInterval interval;
+        if (!parseTimeSlot(time, interval)) 
+        {
+            conflict.kind = InvalidTime;
+            return conflict;
+        }
+
+        auto previous = intervals.find(course);
+        bool rescheduling = previous != intervals.end();
+        TimeInterval oldInterval = rescheduling ? previous->second : TimeInterval();
+        if (rescheduling) 
+        {
+            release(course);
+        }
+        conflict = check(course, interval, room);
+        if (conflict) 
+        {
+            if (rescheduling) 
+            {
+                book(course, oldInterval, timetable[course].second);
+            }
+            return conflict;
+        }
+        book(course, interval, room);
         timetable[course] = {time, room};
+        return conflict;
+    }
+
+    // Assigns a whole term in order and returns one result per request
+    vector<ScheduleConflict> assignSlots(const vector<SlotRequest>& requests) 
+    {
+        vector<ScheduleConflict> results;
+        results.reserve(requests.size());
+        for (const SlotRequest& request : requests) 
+        {
+            results.push_back(assignSlot(request.course, request.time, request.room));
+        }
+        return results;
+    }
+
+    void renderSchedule(ReportWriter& report) const 
+    {
+        for (auto& entry : timetable) 
+        {
+            report.beginRecord();
+            report.field("course", entry.first->getCode());
+            report.field("time", entry.second.first);
+            report.field("room", entry.second.second ? entry.second.second->getRoomNumber() : string());
+            report.endRecord();
+        }
     }
 
     void displaySchedule() const 
@@ -222,39 +1200,2222 @@ public:
         for (auto& entry : timetable) 
         {
             cout << "Course: " << entry.first->getCode() << ", Time: " << entry.second.first
-                 << ", Room: " << entry.second.second->getRoomNumber() << endl;
+                 << ", Room: " << entry.second.second->getRoomNumber() << '\n';
         }
     }
 };
 
 class University 
 {
+    friend class SnapshotWriter;
     vector<Department*> departments;
 public:
     void addDepartment(Department* dept) 
     {
          departments.push_back(dept); 
     }
+    const vector<Department*>& getDepartments() const 
+    {
+         return departments; 
+    }
+    void renderDepartments(ReportWriter& report) const 
+    {
+        for (auto& d : departments)
+        {
+            report.beginRecord();
+            report.field("department", d->getName());
+            report.field("professors", static_cast<int>(d->getProfessors().size()));
+            report.endRecord();
+        }
+    }
+
     void listDepartments() const 
     {
         for (auto& d : departments)
         {
-            cout << d->getName() << endl;
+            cout << d->getName() << '\n';
         }
     }
 };
 
-int main() 
+// Hands out objects of one type from fixed-size slabs instead of one
+// heap allocation per object. Everything is destroyed together by reset(),
+// which keeps the slabs around for the next batch.
+template <typename T>
+class SlabPool 
 {
-    GraduateStudent grad("Bob", 27, "GS001", "9876543210", "2021-08-15", "CS", 3.9, "AI", "Dr. Smith", "AI Optimization");
-    grad.addTeachingHours(10);
-    grad.addResearchHours(15);
-    grad.displayDetails();
-    cout << "Grad Payment: $" << grad.calculatePayment() << endl;
+    static constexpr size_t SlabCapacity = 1024;
 
-    FullProfessor prof("Dr. Jane", 55, "P001", "9123456789", "CS", "AI", "2010-05-01", 15, 6000, 10000);
-    prof.displayDetails();
-    cout << "Prof Payment: $" << prof.calculatePayment() << endl;
+    struct Slab 
+    {
+        alignas(T) unsigned char storage[sizeof(T) * SlabCapacity];
+    };
 
+    vector<unique_ptr<Slab>> slabs;
+    size_t slabIndex = 0;   // slab currently being filled
+    size_t slabUsed = 0;    // objects constructed in that slab
+
+    T* at(size_t slab, size_t i) const 
+    {
+        return reinterpret_cast<T*>(slabs[slab]->storage) + i;
+    }
+
+public:
+    SlabPool() {}
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    ~SlabPool() 
+    {
+         reset(); 
+    }
+
+    template <typename... Args>
+    T* create(Args&&... args) 
+    {
+        if (slabs.empty() || slabUsed == SlabCapacity) 
+        {
+            if (!slabs.empty()) 
+            {
+                ++slabIndex;
+                slabUsed = 0;
+            }
+            if (slabIndex == slabs.size()) 
+            {
+                slabs.emplace_back(new Slab);
+            }
+        }
+        T* object = new (at(slabIndex, slabUsed)) T(std::forward<Args>(args)...);
+        ++slabUsed;
+        return object;
+    }
+
+    size_t size() const 
+    {
+        return slabs.empty() ? 0 : slabIndex * SlabCapacity + slabUsed;
+    }
+
+    void reset() 
+    {
+        if (!is_trivially_destructible<T>::value) 
+        {
+            for (size_t s = 0; s < slabs.size() && s <= slabIndex; ++s) 
+            {
+                size_t count = s < slabIndex ? SlabCapacity : slabUsed;
+                for (size_t i = 0; i < count; ++i) 
+                {
+                    at(s, i)->~T();
+                }
+            }
+        }
+        slabIndex = 0;
+        slabUsed = 0;
+    }
+};
+
+// Owns every person, course, classroom and department of a term.
+// Department, Course, Schedule and University only hold non-owning
+// pointers into the arena; they stay valid until reset() or destruction,
+// which drops the whole term at once.
+class UniversityArena 
+{
+    tuple<SlabPool<Student>, SlabPool<UndergraduateStudent>, SlabPool<GraduateStudent>,
+          SlabPool<AssistantProfessor>, SlabPool<AssociateProfessor>, SlabPool<FullProfessor>,
+          SlabPool<Course>, SlabPool<Classroom>, SlabPool<Department>> pools;
+
+public:
+    UniversityArena() {}
+    UniversityArena(const UniversityArena&) = delete;
+    UniversityArena& operator=(const UniversityArena&) = delete;
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) 
+    {
+        return get<SlabPool<T>>(pools).create(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    size_t count() const 
+    {
+        return get<SlabPool<T>>(pools).size();
+    }
+
+    void reset() 
+    {
+        get<SlabPool<Student>>(pools).reset();
+        get<SlabPool<UndergraduateStudent>>(pools).reset();
+        get<SlabPool<GraduateStudent>>(pools).reset();
+        get<SlabPool<AssistantProfessor>>(pools).reset();
+        get<SlabPool<AssociateProfessor>>(pools).reset();
+        get<SlabPool<FullProfessor>>(pools).reset();
+        get<SlabPool<Course>>(pools).reset();
+        get<SlabPool<Classroom>>(pools).reset();
+        get<SlabPool<Department>>(pools).reset();
+    }
+};
+
+// Binary snapshot of people, courses, classrooms, departments, enrollments
+// and the timetable. Every section is an array of fixed-size records, and
+// records point at each other by index and at text by string-table offset,
+// so a mapped file can be queried in place without rebuilding any objects.
+// Layout: SnapshotHeader, then the sections at the offsets it lists.
+const char SnapshotMagic[8] = {'U', 'N', 'I', 'S', 'N', 'A', 'P', '\0'};
+const uint32_t SnapshotVersion = 1;
+const uint32_t SnapshotByteOrder = 0x01020304;
+const uint32_t SnapshotNone = 0xFFFFFFFF;
+
+enum PersonRole : uint32_t 
+{
+    RolePerson,
+    RoleStudent,
+    RoleUndergraduate,
+    RoleGraduate,
+    RoleAssistantProfessor,
+    RoleAssociateProfessor,
+    RoleFullProfessor
+};
+
+const size_t RoleCount = RoleFullProfessor + 1;
+
+PersonRole roleOf(const Person* person) 
+{
+    if (dynamic_cast<const UndergraduateStudent*>(person)) return RoleUndergraduate;
+    if (dynamic_cast<const GraduateStudent*>(person)) return RoleGraduate;
+    if (dynamic_cast<const Student*>(person)) return RoleStudent;
+    if (dynamic_cast<const AssistantProfessor*>(person)) return RoleAssistantProfessor;
+    if (dynamic_cast<const AssociateProfessor*>(person)) return RoleAssociateProfessor;
+    if (dynamic_cast<const FullProfessor*>(person)) return RoleFullProfessor;
+    return RolePerson;
+}
+
+struct SnapshotSection 
+{
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct SnapshotHeader 
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    SnapshotSection people, peopleByID, courses, classrooms, departments,
+                    departmentMembers, enrollments, slots, strings;
+};
+
+// text[] holds string-table offsets:
+//   all roles:    0 name, 1 id, 2 contact
+//   students:     3 enrollment date, 4 program
+//   undergrads:   5 major, 6 minor, 7 graduation date
+//   graduates:    5 research topic, 6 advisor, 7 thesis title
+//   professors:   3 department, 4 specialization, 5 hire date
+struct PersonRecord 
+{
+    uint32_t role;
+    int32_t age;
+    uint32_t text[8];
+    float gpa;
+    int32_t teachingHours;
+    int32_t researchHours;
+    int32_t yearsOfService;
+    float baseSalary;
+    float researchGrants;
+};
+
+struct CourseRecord 
+{
+    uint32_t code;
+    uint32_t instructor;     // person index or SnapshotNone
+};
+
+struct ClassroomRecord 
+{
+    uint32_t roomNumber;
+};
+
+struct DepartmentRecord 
+{
+    uint32_t name;
+    uint32_t firstMember;    // index into the departmentMembers section
+    uint32_t memberCount;
+};
+
+struct EnrollmentRecord 
+{
+    uint32_t student;
+    uint32_t course;
+};
+
+struct SlotRecord 
+{
+    uint32_t course;
+    uint32_t time;
+    uint32_t room;           // classroom index or SnapshotNone
+};
+
+class SnapshotWriter 
+{
+    vector<PersonRecord> people;
+    vector<CourseRecord> courses;
+    vector<ClassroomRecord> classrooms;
+    vector<DepartmentRecord> departments;
+    vector<uint32_t> departmentMembers;
+    vector<EnrollmentRecord> enrollments;
+    vector<SlotRecord> slots;
+    string strings;
+
+    unordered_map<const Person*, uint32_t> personIndex;
+    unordered_map<const Course*, uint32_t> courseIndex;
+    unordered_map<const Classroom*, uint32_t> classroomIndex;
+    unordered_map<string, uint32_t> stringOffsets;
+
+    // Strings are stored once each as a 32-bit length followed by the bytes
+    uint32_t text(const string& value) 
+    {
+        auto it = stringOffsets.find(value);
+        if (it != stringOffsets.end()) 
+        {
+            return it->second;
+        }
+        uint32_t offset = strings.size();
+        uint32_t length = value.size();
+        strings.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        strings.append(value);
+        strings.append((4 - strings.size() % 4) % 4, '\0');
+        stringOffsets.emplace(value, offset);
+        return offset;
+    }
+
+    template <typename T>
+    static void writeSection(string& image, SnapshotSection& section, const vector<T>& records) 
+    {
+        section.offset = image.size();
+        section.count = records.size();
+        image.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(T));
+        image.append((8 - image.size() % 8) % 8, '\0');
+    }
+
+    // Writes the image to path + ".tmp", flushes it to disk and renames it
+    // over path, so a crash leaves either the old snapshot or the new one
+    static bool replaceFile(const string& path, const string& image) 
+    {
+        string temp = path + ".tmp";
+#ifndef _WIN32
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) 
+        {
+            return false;
+        }
+        size_t done = 0;
+        while (done < image.size()) 
+        {
+            ssize_t n = ::write(fd, image.data() + done, image.size() - done);
+            if (n < 0 && errno == EINTR) 
+            {
+                continue;
+            }
+            if (n <= 0) 
+            {
+                break;
+            }
+            done += n;
+        }
+        bool ok = done == image.size() && fsync(fd) == 0;
+        ok = ::close(fd) == 0 && ok;
+        if (!ok || rename(temp.c_str(), path.c_str()) != 0) 
+        {
+            unlink(temp.c_str());
+            return false;
+        }
+        // Make the rename itself durable
+        size_t slash = path.find_last_of('/');
+        string dir = slash == string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        int dirFd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if (dirFd >= 0) 
+        {
+            fsync(dirFd);
+            ::close(dirFd);
+        }
+        return true;
+#else
+        {
+            ofstream out(temp, ios::binary | ios::trunc);
+            out.write(image.data(), image.size());
+            out.flush();
+            if (!out.good()) 
+            {
+                remove(temp.c_str());
+                return false;
+            }
+        }
+        remove(path.c_str());
+        return rename(temp.c_str(), path.c_str()) == 0;
+#endif
+    }
+
+public:
+    uint32_t addPerson(const Person* person) 
+    {
+        auto it = personIndex.find(person);
+        if (it != personIndex.end()) 
+        {
+            return it->second;
+        }
+        uint32_t index = people.size();
+        personIndex.emplace(person, index);
+
+        PersonRecord record = {};
+        for (uint32_t& t : record.text) 
+        {
+            t = SnapshotNone;
+        }
+        record.role = roleOf(person);
+        record.age = person->age;
+        record.text[0] = text(person->name);
+        record.text[1] = text(person->id);
+        record.text[2] = text(person->contact);
+
+        if (const Student* student = dynamic_cast<const Student*>(person)) 
+        {
+            record.text[3] = text(student->enrollment_date.toString());
+            record.text[4] = text(student->program);
+            record.gpa = student->GPA;
+            if (const UndergraduateStudent* ug = dynamic_cast<const UndergraduateStudent*>(student)) 
+            {
+                record.text[5] = text(ug->major);
+                record.text[6] = text(ug->minor);
+                record.text[7] = text(ug->graduation_date.toString());
+            }
+            else if (const GraduateStudent* grad = dynamic_cast<const GraduateStudent*>(student)) 
+            {
+                record.text[5] = text(grad->research_topic);
+                record.text[6] = text(grad->advisor);
+                record.text[7] = text(grad->thesis_title);
+                record.teachingHours = grad->teaching_assist_hours;
+                record.researchHours = grad->research_assist_hours;
+            }
+        }
+        else if (const Professor* prof = dynamic_cast<const Professor*>(person)) 
+        {
+            record.text[3] = text(prof->department);
+            record.text[4] = text(prof->specialization);
+            record.text[5] = text(prof->hire_date.toString());
+            record.yearsOfService = prof->years_of_service;
+            record.baseSalary = prof->base_salary;
+            record.researchGrants = prof->research_grants;
+        }
+        people.push_back(record);
+
+        if (const Student* student = dynamic_cast<const Student*>(person)) 
+        {
+            for (const Course* course : student->courses) 
+            {
+                enrollments.push_back({index, addCourse(course)});
+            }
+        }
+        return index;
+    }
+
+    uint32_t addCourse(const Course* course) 
+    {
+        auto it = courseIndex.find(course);
+        if (it != courseIndex.end()) 
+        {
+            return it->second;
+        }
+        uint32_t index = courses.size();
+        courseIndex.emplace(course, index);
+        courses.push_back({text(course->getCode()), SnapshotNone});
+        if (course->getInstructor()) 
+        {
+            uint32_t instructor = addPerson(course->getInstructor());
+            courses[index].instructor = instructor;
+        }
+        return index;
+    }
+
+    uint32_t addClassroom(const Classroom* room) 
+    {
+        auto it = classroomIndex.find(room);
+        if (it != classroomIndex.end()) 
+        {
+            return it->second;
+        }
+        uint32_t index = classrooms.size();
+        classroomIndex.emplace(room, index);
+        classrooms.push_back({text(room->getRoomNumber())});
+        return index;
+    }
+
+    void addDepartment(const Department* dept) 
+    {
+        vector<uint32_t> members;
+        for (const Professor* prof : dept->getProfessors()) 
+        {
+            members.push_back(addPerson(prof));
+        }
+        departments.push_back({text(dept->getName()), uint32_t(departmentMembers.size()), uint32_t(members.size())});
+        departmentMembers.insert(departmentMembers.end(), members.begin(), members.end());
+    }
+
+    void addUniversity(const University& university) 
+    {
+        for (const Department* dept : university.departments) 
+        {
+            addDepartment(dept);
+        }
+    }
+
+    void addSchedule(const Schedule& schedule) 
+    {
+        for (const auto& entry : schedule.timetable) 
+        {
+            uint32_t course = addCourse(entry.first);
+            uint32_t room = entry.second.second ? addClassroom(entry.second.second) : SnapshotNone;
+            slots.push_back({course, text(entry.second.first), room});
+        }
+    }
+
+    bool write(const string& path) 
+    {
+        // Person indices sorted by ID text, for binary search on load
+        vector<uint32_t> byID(people.size());
+        for (uint32_t i = 0; i < byID.size(); ++i) 
+        {
+            byID[i] = i;
+        }
+        auto idOf = [&](uint32_t i) 
+        {
+            uint32_t offset = people[i].text[1];
+            uint32_t length;
+            memcpy(&length, strings.data() + offset, sizeof(length));
+            return string_view(strings.data() + offset + sizeof(length), length);
+        };
+        sort(byID.begin(), byID.end(), [&](uint32_t a, uint32_t b) { return idOf(a) < idOf(b); });
+
+        // Sections are laid out after room for the header, which is filled
+        // in once every offset is known
+        SnapshotHeader header = {};
+        string image(sizeof(header), '\0');
+        image.append((8 - image.size() % 8) % 8, '\0');
+
+        writeSection(image, header.people, people);
+        writeSection(image, header.peopleByID, byID);
+        writeSection(image, header.courses, courses);
+        writeSection(image, header.classrooms, classrooms);
+        writeSection(image, header.departments, departments);
+        writeSection(image, header.departmentMembers, departmentMembers);
+        writeSection(image, header.enrollments, enrollments);
+        writeSection(image, header.slots, slots);
+        writeSection(image, header.strings, vector<char>(strings.begin(), strings.end()));
+
+        memcpy(header.magic, SnapshotMagic, sizeof(header.magic));
+        header.version = SnapshotVersion;
+        header.byteOrder = SnapshotByteOrder;
+        memcpy(&image[0], &header, sizeof(header));
+        return replaceFile(path, image);
+    }
+};
+
+// Read-only view of a snapshot file. On POSIX systems the file is mapped
+// with mmap and every accessor reads straight from the mapping.
+class Snapshot 
+{
+    const char* data = nullptr;
+    size_t length = 0;
+    vector<char> buffer;     // used when mmap is not available
+    const SnapshotHeader* header = nullptr;
+
+    template <typename T>
+    const T* section(const SnapshotSection& s) const 
+    {
+        return reinterpret_cast<const T*>(data + s.offset);
+    }
+
+    // In bounds and aligned for T, so section<T>() may be dereferenced
+    template <typename T>
+    bool validSection(const SnapshotSection& s) const 
+    {
+        return s.offset <= length && s.offset % alignof(T) == 0 && s.count <= (length - s.offset) / sizeof(T);
+    }
+
+    bool validText(uint32_t offset) const 
+    {
+        if (offset == SnapshotNone) 
+        {
+            return true;
+        }
+        uint64_t available = header->strings.count;
+        if (offset > available || available - offset < sizeof(uint32_t)) 
+        {
+            return false;
+        }
+        uint32_t size;
+        memcpy(&size, data + header->strings.offset + offset, sizeof(size));
+        return size <= available - offset - sizeof(uint32_t);
+    }
+
+    static bool validIndex(uint32_t index, const SnapshotSection& s, bool optional = false) 
+    {
+        return index < s.count || (optional && index == SnapshotNone);
+    }
+
+    // Checks every string offset and cross-section index once, so the
+    // accessors below can index without further bounds checks
+    bool validRecords() const 
+    {
+        for (size_t i = 0; i < header->people.count; ++i) 
+        {
+            const PersonRecord& p = person(i);
+            if (p.role >= RoleCount) 
+            {
+                return false;
+            }
+            for (uint32_t offset : p.text) 
+            {
+                if (!validText(offset)) 
+                {
+                    return false;
+                }
+            }
+        }
+        const uint32_t* byID = section<uint32_t>(header->peopleByID);
+        for (size_t i = 0; i < header->peopleByID.count; ++i) 
+        {
+            if (!validIndex(byID[i], header->people)) 
+            {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < header->courses.count; ++i) 
+        {
+            if (!validText(course(i).code) || !validIndex(course(i).instructor, header->people, true)) 
+            {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < header->classrooms.count; ++i) 
+        {
+            if (!validText(classroom(i).roomNumber)) 
+            {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < header->departments.count; ++i) 
+        {
+            const DepartmentRecord& d = department(i);
+            if (!validText(d.name) || uint64_t(d.firstMember) + d.memberCount > header->departmentMembers.count) 
+            {
+                return false;
+            }
+        }
+        const uint32_t* members = section<uint32_t>(header->departmentMembers);
+        for (size_t i = 0; i < header->departmentMembers.count; ++i) 
+        {
+            if (!validIndex(members[i], header->people)) 
+            {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < header->enrollments.count; ++i) 
+        {
+            if (!validIndex(enrollment(i).student, header->people) || !validIndex(enrollment(i).course, header->courses)) 
+            {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < header->slots.count; ++i) 
+        {
+            const SlotRecord& s = slot(i);
+            if (!validIndex(s.course, header->courses) || !validText(s.time) ||
+                !validIndex(s.room, header->classrooms, true)) 
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void close() 
+    {
+#ifndef _WIN32
+        if (data && buffer.empty()) 
+        {
+            munmap(const_cast<char*>(data), length);
+        }
+#endif
+        buffer.clear();
+        data = nullptr;
+        header = nullptr;
+        length = 0;
+    }
+
+public:
+    Snapshot() {}
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    ~Snapshot() 
+    {
+         close(); 
+    }
+
+    bool open(const string& path) 
+    {
+        close();
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) 
+        {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) 
+        {
+            void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) 
+            {
+                data = static_cast<const char*>(mapped);
+                length = info.st_size;
+            }
+        }
+        ::close(fd);
+#endif
+        if (!data) 
+        {
+            ifstream in(path, ios::binary);
+            buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+            if (buffer.empty()) 
+            {
+                return false;
+            }
+            data = buffer.data();
+            length = buffer.size();
+        }
+
+        header = reinterpret_cast<const SnapshotHeader*>(data);
+        if (length < sizeof(SnapshotHeader) || memcmp(header->magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0 ||
+            header->version != SnapshotVersion || header->byteOrder != SnapshotByteOrder ||
+            !validSection<PersonRecord>(header->people) ||
+            !validSection<uint32_t>(header->peopleByID) ||
+            !validSection<CourseRecord>(header->courses) ||
+            !validSection<ClassroomRecord>(header->classrooms) ||
+            !validSection<DepartmentRecord>(header->departments) ||
+            !validSection<uint32_t>(header->departmentMembers) ||
+            !validSection<EnrollmentRecord>(header->enrollments) ||
+            !validSection<SlotRecord>(header->slots) ||
+            !validSection<char>(header->strings) || !validRecords()) 
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    size_t personCount() const 
+    {
+         return header->people.count; 
+    }
+    size_t courseCount() const 
+    {
+         return header->courses.count; 
+    }
+    size_t classroomCount() const 
+    {
+         return header->classrooms.count; 
+    }
+    size_t departmentCount() const 
+    {
+         return header->departments.count; 
+    }
+    size_t enrollmentCount() const 
+    {
+         return header->enrollments.count; 
+    }
+    size_t slotCount() const 
+    {
+         return header->slots.count; 
+    }
+
+    const PersonRecord& person(size_t i) const 
+    {
+         return section<PersonRecord>(header->people)[i]; 
+    }
+    const CourseRecord& course(size_t i) const 
+    {
+         return section<CourseRecord>(header->courses)[i]; 
+    }
+    const ClassroomRecord& classroom(size_t i) const 
+    {
+         return section<ClassroomRecord>(header->classrooms)[i]; 
+    }
+    const DepartmentRecord& department(size_t i) const 
+    {
+         return section<DepartmentRecord>(header->departments)[i]; 
+    }
+    uint32_t departmentMember(const DepartmentRecord& dept, size_t i) const 
+    {
+         return section<uint32_t>(header->departmentMembers)[dept.firstMember + i]; 
+    }
+    const EnrollmentRecord& enrollment(size_t i) const 
+    {
+         return section<EnrollmentRecord>(header->enrollments)[i]; 
+    }
+    const SlotRecord& slot(size_t i) const 
+    {
+         return section<SlotRecord>(header->slots)[i]; 
+    }
+
+    string_view text(uint32_t offset) const 
+    {
+        if (offset == SnapshotNone) 
+        {
+            return string_view();
+        }
+        const char* strings = data + header->strings.offset;
+        uint32_t size;
+        memcpy(&size, strings + offset, sizeof(size));
+        return string_view(strings + offset + sizeof(size), size);
+    }
+
+    // Binary search over the ID-sorted index; returns SnapshotNone if absent
+    uint32_t findPerson(string_view id) const 
+    {
+        const uint32_t* byID = section<uint32_t>(header->peopleByID);
+        size_t lo = 0, hi = header->peopleByID.count;
+        while (lo < hi) 
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            string_view midID = text(person(byID[mid]).text[1]);
+            if (midID < id) 
+            {
+                lo = mid + 1;
+            }
+            else 
+            {
+                hi = mid;
+            }
+        }
+        if (lo < header->peopleByID.count && text(person(byID[lo]).text[1]) == id) 
+        {
+            return byID[lo];
+        }
+        return SnapshotNone;
+    }
+};
+
+// Columnar copy of the payment inputs, one partition per role, so payroll
+// runs as plain loops over contiguous arrays instead of virtual calls.
+// Each loop uses the same pay rule as the matching calculatePayment().
+class PersonStore 
+{
+    struct ProfessorColumns 
+    {
+        vector<float> base_salary;
+        vector<int> years_of_service;
+        vector<float> research_grants;
+
+        void add(const Professor& prof) 
+        {
+            base_salary.push_back(prof.getBaseSalary());
+            years_of_service.push_back(prof.getYearsOfService());
+            research_grants.push_back(prof.getResearchGrants());
+        }
+        size_t size() const 
+        {
+             return base_salary.size(); 
+        }
+    };
+
+    size_t studentCount = 0;
+    vector<int> teaching_assist_hours;
+    vector<int> research_assist_hours;
+    ProfessorColumns assistant, associate, full;
+
+public:
+    void add(const Student&) 
+    {
+         ++studentCount; 
+    }
+    void add(const GraduateStudent& grad) 
+    {
+        teaching_assist_hours.push_back(grad.getTeachingHours());
+        research_assist_hours.push_back(grad.getResearchHours());
+    }
+    void add(const AssistantProfessor& prof) 
+    {
+         assistant.add(prof); 
+    }
+    void add(const AssociateProfessor& prof) 
+    {
+         associate.add(prof); 
+    }
+    void add(const FullProfessor& prof) 
+    {
+         full.add(prof); 
+    }
+
+    size_t size() const 
+    {
+        return studentCount + teaching_assist_hours.size() + assistant.size() + associate.size() + full.size();
+    }
+
+    // Writes one payment per person, partition by partition: students,
+    // graduate students, then assistant, associate and full professors.
+    void computePayroll(vector<float>& out) const 
+    {
+        out.resize(size());
+        float* dst = out.data();
+
+        for (size_t i = 0; i < studentCount; ++i) 
+        {
+            dst[i] = 1000.0;
+        }
+        dst += studentCount;
+
+        const int* ta = teaching_assist_hours.data();
+        const int* ra = research_assist_hours.data();
+        for (size_t i = 0; i < teaching_assist_hours.size(); ++i) 
+        {
+            dst[i] = GraduateStudent::pay(ta[i], ra[i]);
+        }
+        dst += teaching_assist_hours.size();
+
+        const float* base = assistant.base_salary.data();
+        const int* years = assistant.years_of_service.data();
+        const float* grants = assistant.research_grants.data();
+        for (size_t i = 0; i < assistant.size(); ++i) 
+        {
+            dst[i] = AssistantRank::pay(base[i], years[i], grants[i]);
+        }
+        dst += assistant.size();
+
+        base = associate.base_salary.data();
+        years = associate.years_of_service.data();
+        grants = associate.research_grants.data();
+        for (size_t i = 0; i < associate.size(); ++i) 
+        {
+            dst[i] = AssociateRank::pay(base[i], years[i], grants[i]);
+        }
+        dst += associate.size();
+
+        base = full.base_salary.data();
+        years = full.years_of_service.data();
+        grants = full.research_grants.data();
+        for (size_t i = 0; i < full.size(); ++i) 
+        {
+            dst[i] = FullRank::pay(base[i], years[i], grants[i]);
+        }
+    }
+
+    double totalPayroll() const 
+    {
+        vector<float> payments;
+        computePayroll(payments);
+        double total = 0.0;
+        for (float p : payments) 
+        {
+            total += p;
+        }
+        return total;
+    }
+};
+
+// Statically dispatched payroll records. Each role is a small value type
+// and the professor rank is a template parameter, so a vector of records
+// is stored contiguously and calculatePayment() inlines instead of going
+// through the Person vtable.
+struct NoPay 
+{
+    float calculatePayment() const 
+    {
+         return 0.0; 
+    }
+};
+
+struct StudentPay 
+{
+    float calculatePayment() const 
+    {
+         return 1000.0; 
+    }
+};
+
+struct GraduatePay 
+{
+    int teaching_assist_hours;
+    int research_assist_hours;
+
+    float calculatePayment() const 
+    {
+         return GraduateStudent::pay(teaching_assist_hours, research_assist_hours); 
+    }
+};
+
+template <typename Rank>
+struct ProfessorPay 
+{
+    float base_salary;
+    int years_of_service;
+    float research_grants;
+
+    float calculatePayment() const 
+    {
+         return Rank::pay(base_salary, years_of_service, research_grants); 
+    }
+};
+
+typedef variant<NoPay, StudentPay, GraduatePay, ProfessorPay<AssistantRank>, ProfessorPay<AssociateRank>,
+                ProfessorPay<FullRank>> PayrollRecord;
+
+inline float calculatePayment(const PayrollRecord& record) 
+{
+    return visit([](const auto& pay) { return pay.calculatePayment(); }, record);
+}
+
+// Captures the payment inputs of a person as a PayrollRecord
+PayrollRecord makePayrollRecord(const Person* person) 
+{
+    switch (roleOf(person)) 
+    {
+    case RoleStudent:
+    case RoleUndergraduate:
+        return StudentPay();
+    case RoleGraduate:
+    {
+        const GraduateStudent* grad = static_cast<const GraduateStudent*>(person);
+        return GraduatePay{grad->getTeachingHours(), grad->getResearchHours()};
+    }
+    case RoleAssistantProfessor:
+    case RoleAssociateProfessor:
+    case RoleFullProfessor:
+    {
+        const Professor* prof = static_cast<const Professor*>(person);
+        float base = prof->getBaseSalary(), grants = prof->getResearchGrants();
+        int years = prof->getYearsOfService();
+        if (roleOf(person) == RoleFullProfessor) 
+        {
+            return ProfessorPay<FullRank>{base, years, grants};
+        }
+        if (roleOf(person) == RoleAssociateProfessor) 
+        {
+            return ProfessorPay<AssociateRank>{base, years, grants};
+        }
+        return ProfessorPay<AssistantRank>{base, years, grants};
+    }
+    default:
+        return NoPay();
+    }
+}
+
+double totalPayroll(const vector<PayrollRecord>& records) 
+{
+    METRIC_TIMER(MetricPayrollTotal);
+    double total = 0.0;
+    for (const PayrollRecord& record : records) 
+    {
+        total += calculatePayment(record);
+    }
+    return total;
+}
+
+struct PayrollReport 
+{
+    size_t people = 0;
+    double total = 0.0;
+    double roleTotals[RoleCount] = {};
+    vector<pair<string, double>> departmentTotals;   // in University order
+    double seconds = 0.0;
+    double peoplePerSecond = 0.0;
+};
+
+// Runs calculatePayment() over a population on several threads. The
+// population is cut into fixed-size blocks; each worker starts on its own
+// run of blocks and, once that is used up, steals blocks from the other
+// workers. Roles and departments are resolved inside the blocks, so the
+// only serial work is indexing the department rosters. Every block writes
+// its partial sums into its own slot and the slots are added up in block
+// order, so the totals are bit-for-bit the same for any thread count.
+class PayrollEngine 
+{
+    struct alignas(64) WorkQueue 
+    {
+        atomic<size_t> next;
+        size_t end;
+    };
+
+    unsigned threads;
+    size_t blockSize;
+
+public:
+    PayrollEngine(unsigned threads = 0, size_t blockSize = 4096)
+        : threads(threads ? threads : max(1u, thread::hardware_concurrency())), blockSize(max<size_t>(1, blockSize)) {}
+
+    // Professors are credited to the first University department that lists them
+    PayrollReport run(const vector<const Person*>& people, const University& university) const 
+    {
+        METRIC_TIMER(MetricPayrollRun);
+        auto start = chrono::steady_clock::now();
+
+        const vector<Department*>& departments = university.getDepartments();
+        unordered_map<const Person*, uint32_t> departmentOf;
+        for (uint32_t d = 0; d < departments.size(); ++d) 
+        {
+            for (const Professor* prof : departments[d]->getProfessors()) 
+            {
+                departmentOf.emplace(prof, d);
+            }
+        }
+
+        // Per block: total, one slot per role, one slot per department
+        size_t blocks = (people.size() + blockSize - 1) / blockSize;
+        size_t stride = 1 + RoleCount + departments.size();
+        vector<double> partials(blocks * stride, 0.0);
+
+        auto processBlock = [&](size_t b) 
+        {
+            double* slot = &partials[b * stride];
+            size_t end = min(people.size(), (b + 1) * blockSize);
+            for (size_t i = b * blockSize; i < end; ++i) 
+            {
+                const Person* person = people[i];
+                PersonRole role = roleOf(person);
+                double payment = person->calculatePayment();
+                slot[0] += payment;
+                slot[1 + role] += payment;
+                // Rosters hold professors, which includes plain RolePerson ones
+                if (role == RolePerson || role >= RoleAssistantProfessor) 
+                {
+                    auto dept = departmentOf.find(person);
+                    if (dept != departmentOf.end()) 
+                    {
+                        slot[1 + RoleCount + dept->second] += payment;
+                    }
+                }
+            }
+        };
+
+        unsigned workers = max<size_t>(1, min<size_t>(threads, blocks));
+        vector<WorkQueue> queues(workers);
+        for (unsigned w = 0; w < workers; ++w) 
+        {
+            queues[w].next = blocks * w / workers;
+            queues[w].end = blocks * (w + 1) / workers;
+        }
+        auto work = [&](unsigned self) 
+        {
+            for (unsigned k = 0; k < workers; ++k) 
+            {
+                WorkQueue& queue = queues[(self + k) % workers];
+                for (size_t b = queue.next.fetch_add(1); b < queue.end; b = queue.next.fetch_add(1)) 
+                {
+                    processBlock(b);
+                }
+            }
+        };
+        vector<thread> pool;
+        for (unsigned w = 1; w < workers; ++w) 
+        {
+            pool.emplace_back(work, w);
+        }
+        work(0);
+        for (thread& t : pool) 
+        {
+            t.join();
+        }
+
+        PayrollReport report;
+        report.people = people.size();
+        vector<double> departmentSums(departments.size(), 0.0);
+        for (size_t b = 0; b < blocks; ++b) 
+        {
+            const double* slot = &partials[b * stride];
+            report.total += slot[0];
+            for (size_t r = 0; r < RoleCount; ++r) 
+            {
+                report.roleTotals[r] += slot[1 + r];
+            }
+            for (size_t d = 0; d < departments.size(); ++d) 
+            {
+                departmentSums[d] += slot[1 + RoleCount + d];
+            }
+        }
+        for (size_t d = 0; d < departments.size(); ++d) 
+        {
+            report.departmentTotals.emplace_back(departments[d]->getName(), departmentSums[d]);
+        }
+
+        report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        report.peoplePerSecond = report.seconds > 0.0 ? report.people / report.seconds : 0.0;
+        return report;
+    }
+};
+
+enum QueryField 
+{
+    FieldDepartment,
+    FieldSpecialization,
+    FieldProgram,
+    FieldAdvisor
+};
+
+const size_t QueryFieldCount = FieldAdvisor + 1;
+
+// Rows matched by a query. When a query is answered by a single index
+// lookup the result borrows that index's row list instead of copying it.
+// Any further predicate or a full scan filters row by row, so those
+// results own a new row vector (4 bytes per matching row, no Person
+// copies). A borrowed result is valid only while its index is unchanged.
+class QueryResult 
+{
+    const vector<const Person*>* people;
+    const vector<uint32_t>* borrowed;
+    vector<uint32_t> owned;
+    string planText;
+
+public:
+    QueryResult(const vector<const Person*>& people, const vector<uint32_t>* rows, string plan)
+        : people(&people), borrowed(rows), planText(plan) {}
+    QueryResult(const vector<const Person*>& people, vector<uint32_t> rows, string plan)
+        : people(&people), borrowed(nullptr), owned(std::move(rows)), planText(plan) {}
+
+    const vector<uint32_t>& rows() const 
+    {
+         return borrowed ? *borrowed : owned; 
+    }
+    size_t size() const 
+    {
+         return rows().size(); 
+    }
+    const Person* operator[](size_t i) const 
+    {
+         return (*people)[rows()[i]]; 
+    }
+    // How the query was answered, e.g. "index role" or "full scan"
+    const string& plan() const 
+    {
+         return planText; 
+    }
+    // True when rows() is an index's own row list rather than a copy
+    bool borrowsIndex() const 
+    {
+         return borrowed != nullptr; 
+    }
+};
+
+// In-memory secondary indexes over people: department, specialization,
+// program, advisor, role and hire date. Text indexes map a value to the
+// rows holding it; the hire-date index is kept sorted for range queries.
+// Build the index first, then query it.
+class UniversityIndex 
+{
+    friend class PersonQuery;
+
+    vector<const Person*> people;
+    unordered_map<string, vector<uint32_t>> textIndex[QueryFieldCount];
+    vector<uint32_t> roleIndex[RoleCount];
+    vector<uint32_t> hireDateIndex;   // professor rows ordered by hire date
+    bool hireDatesSorted = true;
+
+    Date hireDate(uint32_t row) const 
+    {
+        return static_cast<const Professor*>(people[row])->getHireDate();
+    }
+
+public:
+    void add(const Person* person) 
+    {
+        uint32_t row = people.size();
+        people.push_back(person);
+        PersonRole role = roleOf(person);
+        roleIndex[role].push_back(row);
+        if (const Student* student = dynamic_cast<const Student*>(person)) 
+        {
+            textIndex[FieldProgram][student->getProgram()].push_back(row);
+            if (role == RoleGraduate) 
+            {
+                textIndex[FieldAdvisor][static_cast<const GraduateStudent*>(person)->getAdvisor()].push_back(row);
+            }
+        }
+        else if (const Professor* prof = dynamic_cast<const Professor*>(person)) 
+        {
+            textIndex[FieldDepartment][prof->getDepartment()].push_back(row);
+            textIndex[FieldSpecialization][prof->getSpecialization()].push_back(row);
+            hireDateIndex.push_back(row);
+            hireDatesSorted = false;
+        }
+    }
+
+    void addUniversity(const University& university) 
+    {
+        for (const Department* dept : university.getDepartments()) 
+        {
+            for (const Professor* prof : dept->getProfessors()) 
+            {
+                add(prof);
+            }
+        }
+    }
+
+    // Sorts the hire-date index; call after the last add()
+    void build() 
+    {
+        if (!hireDatesSorted) 
+        {
+            stable_sort(hireDateIndex.begin(), hireDateIndex.end(),
+                        [&](uint32_t a, uint32_t b) { return hireDate(a) < hireDate(b); });
+            hireDatesSorted = true;
+        }
+    }
+
+    size_t size() const 
+    {
+         return people.size(); 
+    }
+};
+
+// Conjunction of predicates over a UniversityIndex. run() estimates each
+// indexed predicate by the length of its row list, drives the query from
+// the most selective one and checks the rest row by row; with no indexed
+// predicate it falls back to a full scan. Only a lone indexed predicate
+// returns a borrowed view; combined predicates build their own row list.
+class PersonQuery 
+{
+    const UniversityIndex& index;
+    vector<pair<QueryField, string>> equals;
+    vector<PersonRole> roles;
+    bool hasHireRange = false;
+    Date hiredFrom, hiredTo;
+    vector<function<bool(const Person*)>> filters;
+
+    static const vector<uint32_t>& emptyRows() 
+    {
+        static const vector<uint32_t> none;
+        return none;
+    }
+
+    bool matchesField(uint32_t row, QueryField field, const string& value) const 
+    {
+        const Person* person = index.people[row];
+        switch (field) 
+        {
+        case FieldDepartment:
+        case FieldSpecialization:
+        {
+            const Professor* prof = dynamic_cast<const Professor*>(person);
+            return prof && (field == FieldDepartment ? prof->getDepartment() : prof->getSpecialization()) == value;
+        }
+        case FieldProgram:
+        {
+            const Student* student = dynamic_cast<const Student*>(person);
+            return student && student->getProgram() == value;
+        }
+        case FieldAdvisor:
+        {
+            const GraduateStudent* grad = dynamic_cast<const GraduateStudent*>(person);
+            return grad && grad->getAdvisor() == value;
+        }
+        }
+        return false;
+    }
+
+    bool matches(uint32_t row) const 
+    {
+        for (auto& predicate : equals) 
+        {
+            if (!matchesField(row, predicate.first, predicate.second)) 
+            {
+                return false;
+            }
+        }
+        if (!roles.empty() && find(roles.begin(), roles.end(), roleOf(index.people[row])) == roles.end()) 
+        {
+            return false;
+        }
+        if (hasHireRange) 
+        {
+            const Professor* prof = dynamic_cast<const Professor*>(index.people[row]);
+            if (!prof || prof->getHireDate() < hiredFrom || prof->getHireDate() > hiredTo) 
+            {
+                return false;
+            }
+        }
+        for (auto& filter : filters) 
+        {
+            if (!filter(index.people[row])) 
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    explicit PersonQuery(const UniversityIndex& index) : index(index) {}
+
+    PersonQuery& where(QueryField field, const string& value) 
+    {
+        equals.emplace_back(field, value);
+        return *this;
+    }
+
+    // Several calls widen the match to any of the given roles
+    PersonQuery& whereRole(PersonRole role) 
+    {
+        roles.push_back(role);
+        return *this;
+    }
+
+    // Inclusive range of ISO dates, e.g. "2010-01-01" to "2015-12-31"
+    PersonQuery& hiredBetween(const string& from, const string& to) 
+    {
+        hasHireRange = true;
+        hiredFrom = Date::parse(from);
+        hiredTo = Date::parse(to);
+        return *this;
+    }
+
+    // Any extra condition, e.g. grants above a threshold; checked per row
+    PersonQuery& filter(function<bool(const Person*)> predicate) 
+    {
+        filters.push_back(std::move(predicate));
+        return *this;
+    }
+
+    QueryResult run() const 
+    {
+        const vector<uint32_t>* driver = nullptr;
+        size_t hireBegin = 0, hireEnd = 0;
+        string plan = "full scan";
+        bool byHireDate = false;
+        vector<uint32_t> hireRows;
+
+        for (auto& predicate : equals) 
+        {
+            auto it = index.textIndex[predicate.first].find(predicate.second);
+            const vector<uint32_t>* rows = it == index.textIndex[predicate.first].end() ? &emptyRows() : &it->second;
+            if (!driver || rows->size() < driver->size()) 
+            {
+                driver = rows;
+                static const char* names[] = {"department", "specialization", "program", "advisor"};
+                plan = string("index ") + names[predicate.first];
+            }
+        }
+        if (roles.size() == 1 && (!driver || index.roleIndex[roles[0]].size() < driver->size())) 
+        {
+            driver = &index.roleIndex[roles[0]];
+            plan = "index role";
+        }
+        if (hasHireRange && index.hireDatesSorted) 
+        {
+            auto& dates = index.hireDateIndex;
+            hireBegin = lower_bound(dates.begin(), dates.end(), hiredFrom,
+                [&](uint32_t row, Date date) { return index.hireDate(row) < date; }) - dates.begin();
+            hireEnd = upper_bound(dates.begin(), dates.end(), hiredTo,
+                [&](Date date, uint32_t row) { return date < index.hireDate(row); }) - dates.begin();
+            hireEnd = max(hireBegin, hireEnd);
+            if (!driver || hireEnd - hireBegin < driver->size()) 
+            {
+                hireRows.assign(dates.begin() + hireBegin, dates.begin() + hireEnd);
+                sort(hireRows.begin(), hireRows.end());
+                byHireDate = true;
+                plan = "index hire_date";
+            }
+        }
+
+        vector<uint32_t> result;
+        if (byHireDate) 
+        {
+            for (uint32_t row : hireRows) 
+            {
+                if (matches(row)) result.push_back(row);
+            }
+        }
+        else if (driver) 
+        {
+            // A single predicate answered by its index needs no copy
+            if (equals.size() + roles.size() + hasHireRange == 1 && filters.empty()) 
+            {
+                return QueryResult(index.people, driver, plan);
+            }
+            for (uint32_t row : *driver) 
+            {
+                if (matches(row)) result.push_back(row);
+            }
+        }
+        else 
+        {
+            for (uint32_t row = 0; row < index.people.size(); ++row) 
+            {
+                if (matches(row)) result.push_back(row);
+            }
+        }
+        return QueryResult(index.people, std::move(result), plan);
+    }
+};
+
+struct TimetableSolution 
+{
+    vector<SlotRequest> assignments;
+    size_t conflicts = 0;      // clashing pairs left; 0 means conflict-free
+    size_t moves = 0;          // moves evaluated across all threads
+    double seconds = 0.0;
+};
+
+// Places every course into one of the candidate times and one of the rooms
+// so that no room, instructor or enrolled student is double-booked. Each
+// thread runs its own simulated-annealing search from a different seed
+// (a parallel portfolio) and the best timetable wins. The candidate times
+// must not overlap one another.
+//
+// The search keeps use counts per (time, room), (time, instructor) and
+// (time, student). The cost is the number of clashing pairs, so moving a
+// course only touches its own room, instructor and students: O(students in
+// the course) per move instead of re-scoring the whole timetable. The best
+// timetable is copied out only when the search is about to climb away from
+// it, not on every improvement of a downhill run.
+class TimetableSolver 
+{
+    struct Problem 
+    {
+        size_t courses, times, rooms, instructors, students;
+        vector<int> instructorOf;                  // -1 when the course has none
+        vector<vector<uint32_t>> studentsOf;       // per course
+    };
+
+    struct Search 
+    {
+        const Problem& problem;
+        vector<uint32_t> roomUse, instructorUse, studentUse;   // a cell can count every course
+        vector<uint32_t> time, room;
+        size_t cost = 0;
+
+        explicit Search(const Problem& p)
+            : problem(p), roomUse(p.times * p.rooms), instructorUse(p.times * p.instructors),
+              studentUse(p.times * p.students), time(p.courses), room(p.courses) {}
+
+        // Clashing pairs the course has or would have at (t, r). When it is
+        // placed, its own counts at time[c] (and room[c]) are left out, so a
+        // room-only move at the same time is not charged for the course's
+        // own instructor and students.
+        long clashes(size_t c, uint32_t t, uint32_t r, bool placed) const 
+        {
+            long sameTime = placed && t == time[c];
+            long total = roomUse[t * problem.rooms + r] - (sameTime && r == room[c]);
+            if (problem.instructorOf[c] >= 0) 
+            {
+                total += instructorUse[t * problem.instructors + problem.instructorOf[c]] - sameTime;
+            }
+            for (uint32_t s : problem.studentsOf[c]) 
+            {
+                total += studentUse[t * problem.students + s] - sameTime;
+            }
+            return total;
+        }
+
+        void apply(size_t c, uint32_t t, uint32_t r, int change) 
+        {
+            roomUse[t * problem.rooms + r] += change;
+            if (problem.instructorOf[c] >= 0) 
+            {
+                instructorUse[t * problem.instructors + problem.instructorOf[c]] += change;
+            }
+            for (uint32_t s : problem.studentsOf[c]) 
+            {
+                studentUse[t * problem.students + s] += change;
+            }
+        }
+
+        void place(size_t c, uint32_t t, uint32_t r) 
+        {
+            cost += clashes(c, t, r, false);
+            apply(c, t, r, +1);
+            time[c] = t;
+            room[c] = r;
+        }
+
+        void move(size_t c, uint32_t t, uint32_t r) 
+        {
+            cost -= clashes(c, time[c], room[c], true);
+            apply(c, time[c], room[c], -1);
+            place(c, t, r);
+        }
+    };
+
+    unsigned threads;
+    double timeBudget;
+    uint64_t seed;
+
+public:
+    TimetableSolver(double timeBudgetSeconds = 1.0, unsigned threads = 0, uint64_t seed = 1)
+        : threads(threads ? threads : max(1u, thread::hardware_concurrency())), timeBudget(timeBudgetSeconds), seed(seed) {}
+
+    TimetableSolution solve(const vector<Course*>& courses, const vector<Classroom*>& rooms,
+                            const vector<const Student*>& students, const vector<string>& times) const 
+    {
+        auto start = chrono::steady_clock::now();
+        TimetableSolution solution;
+        if (courses.empty() || rooms.empty() || times.empty()) 
+        {
+            return solution;
+        }
+
+        Problem problem;
+        problem.courses = courses.size();
+        problem.times = times.size();
+        problem.rooms = rooms.size();
+        problem.students = students.size();
+        problem.studentsOf.resize(courses.size());
+        unordered_map<const Course*, uint32_t> courseIndex;
+        unordered_map<const Professor*, int> instructorIndex;
+        for (size_t c = 0; c < courses.size(); ++c) 
+        {
+            courseIndex.emplace(courses[c], c);
+            const Professor* instructor = courses[c]->getInstructor();
+            int index = -1;
+            if (instructor) 
+            {
+                index = instructorIndex.emplace(instructor, instructorIndex.size()).first->second;
+            }
+            problem.instructorOf.push_back(index);
+        }
+        problem.instructors = instructorIndex.size();
+        for (uint32_t s = 0; s < students.size(); ++s) 
+        {
+            for (Course* course : students[s]->getCourses()) 
+            {
+                auto it = courseIndex.find(course);
+                if (it != courseIndex.end()) 
+                {
+                    problem.studentsOf[it->second].push_back(s);
+                }
+            }
+        }
+        for (vector<uint32_t>& members : problem.studentsOf) 
+        {
+            members.erase(unique(members.begin(), members.end()), members.end());   // a course listed twice
+        }
+
+        atomic<bool> solved(false);
+        atomic<size_t> moves(0);
+        vector<size_t> bestCost(threads);
+        vector<vector<uint32_t>> bestTime(threads), bestRoom(threads);
+
+        auto work = [&](unsigned self) 
+        {
+            mt19937_64 rng(seed + self);
+            auto pick = [&](size_t n) 
+            {
+                return uint32_t(rng() % n);
+            };
+            Search search(problem);
+            for (size_t c = 0; c < problem.courses; ++c) 
+            {
+                search.place(c, pick(problem.times), pick(problem.rooms));
+            }
+            bestCost[self] = search.cost;
+            bestTime[self] = search.time;
+            bestRoom[self] = search.room;
+            bool unsaved = false;   // search is at bestCost but not yet copied
+
+            double temperature = 2.0;
+            size_t local = 0;
+            while (search.cost > 0 && !solved) 
+            {
+                if (++local % 1024 == 0) 
+                {
+                    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                    if (elapsed >= timeBudget) 
+                    {
+                        break;
+                    }
+                    temperature = max(0.05, 2.0 * (1.0 - elapsed / timeBudget));
+                }
+
+                size_t c = pick(problem.courses);
+                long current = search.clashes(c, search.time[c], search.room[c], true);
+                if (current == 0 && pick(8) != 0) 
+                {
+                    continue;   // mostly move courses that are in a clash
+                }
+                uint32_t t = pick(problem.times), r = pick(problem.rooms);
+                if (t == search.time[c] && r == search.room[c]) 
+                {
+                    continue;
+                }
+                long delta = search.clashes(c, t, r, true) - current;
+                if (delta <= 0 || generate_canonical<double, 32>(rng) < exp(-delta / temperature)) 
+                {
+                    if (delta > 0 && unsaved) 
+                    {
+                        bestTime[self] = search.time;
+                        bestRoom[self] = search.room;
+                        unsaved = false;
+                    }
+                    search.move(c, t, r);
+                    if (search.cost < bestCost[self]) 
+                    {
+                        bestCost[self] = search.cost;
+                        unsaved = true;
+                    }
+                }
+            }
+            if (unsaved) 
+            {
+                bestTime[self] = search.time;
+                bestRoom[self] = search.room;
+            }
+            if (search.cost == 0) 
+            {
+                solved = true;
+            }
+            moves += local;
+        };
+
+        vector<thread> pool;
+        for (unsigned w = 1; w < threads; ++w) 
+        {
+            pool.emplace_back(work, w);
+        }
+        work(0);
+        for (thread& t : pool) 
+        {
+            t.join();
+        }
+
+        size_t best = min_element(bestCost.begin(), bestCost.end()) - bestCost.begin();
+        for (size_t c = 0; c < courses.size(); ++c) 
+        {
+            solution.assignments.push_back({courses[c], times[bestTime[best][c]], rooms[bestRoom[best][c]]});
+        }
+        solution.conflicts = bestCost[best];
+        solution.moves = moves;
+        solution.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return solution;
+    }
+};
+
+// Reduced copy of the runner in 2assignment.cpp: times named workloads
+// (best and mean of several runs) and prints the same JSON document
+class BenchmarkRunner 
+{
+    string program;
+    uint64_t seed;
+    unsigned repeats;
+    ostringstream parameters, results;   // JSON members, written as they arrive
+
+public:
+    BenchmarkRunner(const string& program, uint64_t seed, unsigned repeats = 5)
+        : program(program), seed(seed), repeats(max(1u, repeats)) 
+    {
+        results.precision(12);
+    }
+
+    void parameter(const string& name, size_t value) 
+    {
+        parameters << (parameters.tellp() > 0 ? ", " : "") << '"' << name << "\": " << value;
+    }
+
+    // setup() runs untimed before every repetition of workload()
+    template <typename Setup, typename Workload>
+    void run(const string& name, size_t operations, Setup setup, Workload workload) 
+    {
+        double best = numeric_limits<double>::max(), mean = 0.0, checksum = 0.0;
+        for (unsigned r = 0; r < repeats; ++r) 
+        {
+            setup();
+            auto start = chrono::steady_clock::now();
+            checksum = workload();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            best = min(best, seconds);
+            mean += seconds / repeats;
+        }
+        results << (results.tellp() > 0 ? "," : "") << "\n    {\"name\": \"" << name << "\", \"operations\": " << operations
+                << ", \"best_seconds\": " << best << ", \"mean_seconds\": " << mean
+                << ", \"ops_per_second\": " << (best > 0 ? operations / best : 0.0) << ", \"checksum\": " << checksum << "}";
+    }
+
+    template <typename Workload>
+    void run(const string& name, size_t operations, Workload workload) 
+    {
+        run(name, operations, [] {}, workload);
+    }
+
+    void writeJson(ostream& out) const 
+    {
+        out << "{\n  \"program\": \"" << program << "\",\n  \"seed\": " << seed << ",\n  \"repeats\": " << repeats
+            << ",\n  \"parameters\": {" << parameters.str() << "},\n  \"benchmarks\": [" << results.str() << "\n  ]\n}\n";
+    }
+};
+
+struct GeneratorConfig 
+{
+    size_t students = 10000;
+    size_t professors = 500;
+    size_t courses = 400;
+    size_t classrooms = 60;
+    size_t coursesPerStudent = 5;
+    double graduateShare = 0.2;
+    double courseSkew = 1.1;     // Zipf exponent of course popularity
+    uint64_t seed = 42;
+};
+
+// Everything produced by one UniversityGenerator run; the people, courses
+// and rooms live in the arena and are freed with it.
+struct SyntheticUniversity 
+{
+    UniversityArena arena;
+    University university;
+    vector<Department*> departments;
+    vector<Student*> students;
+    vector<Professor*> professors;
+    vector<Course*> courses;
+    vector<Classroom*> classrooms;
+    vector<pair<size_t, size_t>> enrollments;   // (student, course) indices
+    vector<float> grades;                       // one per enrollment
+    vector<SlotRequest> slots;                  // one per course
+};
+
+// Builds a synthetic university of the configured size. The output depends
+// only on the config: random numbers come from mt19937_64 (whose sequence
+// the standard fixes) turned into values by hand rather than through the
+// library's distributions, which differ between implementations.
+// Course popularity follows a Zipf law, so a few courses get most of the
+// enrollments, and grades cluster around the high 60s.
+class UniversityGenerator 
+{
+    GeneratorConfig config;
+    mutable mt19937_64 rng;
+
+    double uniform() const 
+    {
+        return (rng() >> 11) * 0x1.0p-53;
+    }
+
+    size_t below(size_t n) const 
+    {
+        return static_cast<size_t>(uniform() * n);
+    }
+
+    // Sum of four uniforms: a bell curve on [mean - 2 spread, mean + 2 spread]
+    double bell(double mean, double spread) const 
+    {
+        return mean + (uniform() + uniform() + uniform() + uniform() - 2.0) * spread;
+    }
+
+    static string pad(size_t n, size_t width) 
+    {
+        string digits = to_string(n);
+        return string(digits.size() < width ? width - digits.size() : 0, '0') + digits;
+    }
+
+    static string date(size_t year, size_t month, size_t day) 
+    {
+        return to_string(year) + "-" + pad(month, 2) + "-" + pad(day, 2);
+    }
+
+public:
+    explicit UniversityGenerator(const GeneratorConfig& config) : config(config), rng(config.seed) {}
+
+    void generate(SyntheticUniversity& out) const 
+    {
+        static const char* const departmentNames[] = {"Computer Science", "Mathematics", "Physics", "Chemistry",
+                                                      "Biology", "Economics", "History", "Engineering"};
+        static const char* const days[] = {"Mon", "Tue", "Wed", "Thu", "Fri"};
+        rng.seed(config.seed);
+
+        for (const char* name : departmentNames) 
+        {
+            out.departments.push_back(out.arena.create<Department>(name));
+            out.university.addDepartment(out.departments.back());
+        }
+
+        // 40% assistant, 35% associate, 25% full professors
+        for (size_t i = 0; i < config.professors; ++i) 
+        {
+            Department* dept = out.departments[i % out.departments.size()];
+            string id = "P" + pad(i, 6);
+            int years = static_cast<int>(below(35));
+            float salary = static_cast<float>(bell(90000.0, 20000.0));
+            float grants = uniform() < 0.4 ? static_cast<float>(uniform() * 200000.0) : 0.0f;
+            string hired = date(2024 - years, 1 + below(12), 1 + below(28));
+            double rank = uniform();
+            Professor* prof;
+            if (rank < 0.40) 
+            {
+                prof = out.arena.create<AssistantProfessor>("Prof " + id, 30 + years, id, "555" + pad(i, 7), dept->getName(),
+                                                           "General", hired, years, salary, grants);
+            }
+            else if (rank < 0.75) 
+            {
+                prof = out.arena.create<AssociateProfessor>("Prof " + id, 35 + years, id, "555" + pad(i, 7), dept->getName(),
+                                                           "General", hired, years, salary, grants);
+            }
+            else 
+            {
+                prof = out.arena.create<FullProfessor>("Prof " + id, 40 + years, id, "555" + pad(i, 7), dept->getName(),
+                                                      "General", hired, years, salary, grants);
+            }
+            dept->addProfessor(prof);
+            out.professors.push_back(prof);
+        }
+
+        for (size_t i = 0; i < config.classrooms; ++i) 
+        {
+            out.classrooms.push_back(out.arena.create<Classroom>("R" + pad(i, 4)));
+        }
+
+        for (size_t i = 0; i < config.courses; ++i) 
+        {
+            Professor* instructor = out.professors.empty() ? nullptr : out.professors[below(out.professors.size())];
+            out.courses.push_back(out.arena.create<Course>("C" + pad(i, 5), instructor));
+            size_t start = 8 + below(9);
+            string time = string(days[below(5)]) + " " + pad(start, 2) + ":00-" + pad(start + 1, 2) + ":30";
+            Classroom* room = out.classrooms.empty() ? nullptr : out.classrooms[below(out.classrooms.size())];
+            out.slots.push_back(SlotRequest{out.courses.back(), time, room});
+        }
+
+        // Cumulative Zipf weights over course rank
+        vector<double> popularity(config.courses);
+        double total = 0.0;
+        for (size_t i = 0; i < config.courses; ++i) 
+        {
+            total += 1.0 / pow(i + 1.0, config.courseSkew);
+            popularity[i] = total;
+        }
+
+        for (size_t i = 0; i < config.students; ++i) 
+        {
+            string id = "S" + pad(i, 7);
+            string program = departmentNames[below(8)];
+            string enrolled = date(2019 + below(6), 9, 1);
+            float gpa = static_cast<float>(min(4.0, max(0.0, bell(3.0, 0.6))));
+            Student* student;
+            if (uniform() < config.graduateShare) 
+            {
+                size_t advisor = out.professors.empty() ? 0 : below(out.professors.size());
+                GraduateStudent* grad = out.arena.create<GraduateStudent>(
+                    "Student " + id, 22 + below(10), id, "777" + pad(i, 7), enrolled, program, gpa, "Research",
+                    out.professors.empty() ? string() : out.professors[advisor]->getName(), "Thesis " + id);
+                grad->addTeachingHours(static_cast<int>(below(20)));
+                grad->addResearchHours(static_cast<int>(below(20)));
+                student = grad;
+            }
+            else 
+            {
+                student = out.arena.create<UndergraduateStudent>("Student " + id, 17 + below(8), id, "777" + pad(i, 7), enrolled,
+                                                                 program, gpa, program, "", date(2025 + below(4), 6, 1));
+            }
+            out.students.push_back(student);
+
+            size_t wanted = min(config.coursesPerStudent, config.courses);
+            vector<size_t> taken;
+            for (size_t attempt = 0; taken.size() < wanted && attempt < wanted * 8; ++attempt) 
+            {
+                size_t course = lower_bound(popularity.begin(), popularity.end(), uniform() * total) - popularity.begin();
+                course = min(course, config.courses - 1);
+                if (find(taken.begin(), taken.end(), course) != taken.end()) 
+                {
+                    continue;
+                }
+                taken.push_back(course);
+                student->enrollInCourse(out.courses[course]);
+                out.enrollments.emplace_back(i, course);
+                out.grades.push_back(static_cast<float>(min(100.0, max(0.0, bell(68.0, 18.0)))));
+            }
+        }
+    }
+};
+
+// Runs the payroll, arena, scheduling and timetable solver workloads on a
+// generated university and prints the results as JSON. Usage: --bench [students] [seed]
+int runBenchmarks(int argc, char* argv[]) 
+{
+    GeneratorConfig config;
+    if (argc > 2) 
+    {
+        config.students = stoul(argv[2]);
+        config.professors = max<size_t>(1, config.students / 20);
+        config.courses = max<size_t>(1, config.students / 25);
+        config.classrooms = max<size_t>(1, config.courses / 6);
+    }
+    if (argc > 3) 
+    {
+        config.seed = stoull(argv[3]);
+    }
+
+    SyntheticUniversity data;
+    UniversityGenerator(config).generate(data);
+
+    vector<const Person*> people(data.students.begin(), data.students.end());
+    people.insert(people.end(), data.professors.begin(), data.professors.end());
+    vector<PayrollRecord> records;
+    for (const Person* person : people) 
+    {
+        records.push_back(makePayrollRecord(person));
+    }
+
+    BenchmarkRunner bench("3assignment", config.seed);
+    bench.parameter("students", config.students);
+    bench.parameter("professors", config.professors);
+    bench.parameter("courses", config.courses);
+    bench.parameter("classrooms", config.classrooms);
+    bench.parameter("enrollments", data.enrollments.size());
+
+    bench.run("payroll_virtual", people.size(), [&] {
+        double total = 0.0;
+        for (const Person* person : people) 
+        {
+            total += person->calculatePayment();
+        }
+        return total;
+    });
+    bench.run("payroll_static", records.size(), [&] { return totalPayroll(records); });
+    bench.run("payroll_engine", people.size(), [&] { return PayrollEngine().run(people, data.university).total; });
+
+    PersonStore columns;
+    for (const Person* person : people) 
+    {
+        switch (roleOf(person)) 
+        {
+        case RoleStudent:
+        case RoleUndergraduate:
+            columns.add(static_cast<const Student&>(*person));
+            break;
+        case RoleGraduate:
+            columns.add(static_cast<const GraduateStudent&>(*person));
+            break;
+        case RoleAssistantProfessor:
+            columns.add(static_cast<const AssistantProfessor&>(*person));
+            break;
+        case RoleAssociateProfessor:
+            columns.add(static_cast<const AssociateProfessor&>(*person));
+            break;
+        case RoleFullProfessor:
+            columns.add(static_cast<const FullProfessor&>(*person));
+            break;
+        case RolePerson:
+            break;
+        }
+    }
+    bench.run("payroll_person_store", columns.size(), [&] { return columns.totalPayroll(); });
+
+    unique_ptr<Schedule> schedule;
+    bench.run("schedule_add_students", data.enrollments.size(), [&] { schedule.reset(new Schedule()); }, [&] {
+        for (const Student* student : data.students) 
+        {
+            schedule->addStudent(student);
+        }
+        return static_cast<double>(data.students.size());
+    });
+    bench.run("schedule_assign_slots", data.slots.size(),
+              [&] {
+                  schedule.reset(new Schedule());
+                  for (const Student* student : data.students) 
+                  {
+                      schedule->addStudent(student);
+                  }
+              },
+              [&] {
+                  double booked = 0.0;
+                  for (const ScheduleConflict& conflict : schedule->assignSlots(data.slots)) 
+                  {
+                      booked += conflict.kind == NoConflict;
+                  }
+                  return booked;
+              });
+
+    // A million small objects from the arena against one new/delete each;
+    // creation and release are both timed
+    const size_t allocations = 1000000;
+    UniversityArena arena;
+    bench.run("arena_create_release", allocations, [&] {
+        for (size_t i = 0; i < allocations; ++i) 
+        {
+            arena.create<Course>("C", nullptr);
+        }
+        double created = arena.count<Course>();
+        arena.reset();
+        return created;
+    });
+    vector<Course*> heapCourses(allocations);
+    bench.run("heap_new_delete", allocations, [&] {
+        for (size_t i = 0; i < allocations; ++i) 
+        {
+            heapCourses[i] = new Course("C", nullptr);
+        }
+        for (Course* course : heapCourses) 
+        {
+            delete course;
+        }
+        return static_cast<double>(allocations);
+    });
+
+    // Timetable search on growing universities with a one-second budget at
+    // 1, 4 and all hardware threads. A budgeted search has no fixed amount
+    // of work, so instead of a timed case each run reports the clashes left,
+    // the moves evaluated and the milliseconds it took as parameters.
+    vector<string> candidateTimes;
+    for (const char* day : {"Mon", "Tue", "Wed", "Thu", "Fri"}) 
+    {
+        for (const char* hours : {"08:00-09:30", "10:00-11:30", "12:00-13:30", "14:00-15:30", "16:00-17:30"}) 
+        {
+            candidateTimes.push_back(string(day) + " " + hours);
+        }
+    }
+    vector<unsigned> threadCounts = {1, 4};
+    unsigned allThreads = max(1u, thread::hardware_concurrency());
+    if (find(threadCounts.begin(), threadCounts.end(), allThreads) == threadCounts.end()) 
+    {
+        threadCounts.push_back(allThreads);
+    }
+    bench.parameter("solver_hardware_threads", allThreads);
+    for (size_t students : {500, 2000, 8000, 32000}) 
+    {
+        GeneratorConfig sized = config;
+        sized.students = students;
+        sized.professors = max<size_t>(1, students / 20);
+        sized.courses = max<size_t>(1, students / 25);
+        sized.classrooms = max<size_t>(1, sized.courses / 6);
+        SyntheticUniversity instance;
+        UniversityGenerator(sized).generate(instance);
+        vector<const Student*> enrolled(instance.students.begin(), instance.students.end());
+        for (unsigned threads : threadCounts) 
+        {
+            TimetableSolution solution = TimetableSolver(1.0, threads, config.seed)
+                                             .solve(instance.courses, instance.classrooms, enrolled, candidateTimes);
+            string name = "solver_" + to_string(students) + "_t" + to_string(threads);
+            bench.parameter(name + "_clashes", solution.conflicts);
+            bench.parameter(name + "_moves", solution.moves);
+            bench.parameter(name + "_ms", static_cast<size_t>(solution.seconds * 1000));
+        }
+    }
+
+    bench.writeJson(cout);
+    return 0;
+}
+
+int main(int argc, char* argv[]) 
+{
+    if (argc > 1 && string(argv[1]) == "--bench") 
+    {
+        return runBenchmarks(argc, argv);
+    }
+
+    // Files are only written when asked for: --metrics PATH, --snapshot PATH
+    string metricsPath, snapshotPath;
+    for (int i = 1; i + 1 < argc; ++i) 
+    {
+        string option = argv[i];
+        if (option == "--metrics") 
+        {
+            metricsPath = argv[++i];
+        }
+        else if (option == "--snapshot") 
+        {
+            snapshotPath = argv[++i];
+        }
+    }
+
+    GraduateStudent grad("Bob", 27, "GS001", "9876543210", "2021-08-15", "CS", 3.9, "AI", "Dr. Smith", "AI Optimization");
+    grad.addTeachingHours(10);
+    grad.addResearchHours(15);
+    grad.displayDetails();
+    cout << "Grad Payment: $" << grad.calculatePayment() << endl;
+
+    FullProfessor prof("Dr. Jane", 55, "P001", "9123456789", "CS", "AI", "2010-05-01", 15, 6000, 10000);
+    prof.displayDetails();
+    cout << "Prof Payment: $" << prof.calculatePayment() << endl;
+
+    PersonStore payroll;
+    payroll.add(grad);
+    payroll.add(prof);
+    cout << "Total Payroll: $" << payroll.totalPayroll() << endl;
+
+    UniversityArena arena;
+    AssociateProfessor* lecturer = arena.create<AssociateProfessor>("Dr. Lee", 42, "P002", "9123456780", "CS", "Systems",
+                                                                    "2014-07-01", 8, 5000, 4000);
+    Course* course = arena.create<Course>("CS301", lecturer);
+    Classroom* room = arena.create<Classroom>("B-204");
+    Schedule schedule;
+    schedule.assignSlot(course, "Mon 10:00", room);
+    schedule.displaySchedule();
+
+    grad.enrollInCourse(course);
+    Department* cs = arena.create<Department>("CS");
+    cs->addProfessor(&prof);
+    cs->addProfessor(lecturer);
+    University university;
+    university.addDepartment(cs);
+
+    SnapshotWriter writer;
+    writer.addPerson(&grad);
+    writer.addUniversity(university);
+    writer.addSchedule(schedule);
+    Snapshot snapshot;
+    if (!snapshotPath.empty() && writer.write(snapshotPath) && snapshot.open(snapshotPath)) 
+    {
+        uint32_t found = snapshot.findPerson("P002");
+        cout << "Snapshot: " << snapshot.personCount() << " people, " << snapshot.courseCount() << " courses, "
+             << snapshot.enrollmentCount() << " enrollments; P002 is "
+             << (found == SnapshotNone ? "missing" : string(snapshot.text(snapshot.person(found).text[0]))) << endl;
+    }
+
+    vector<PayrollRecord> records;
+    for (const Person* person : {static_cast<const Person*>(&grad), static_cast<const Person*>(&prof),
+                                 static_cast<const Person*>(lecturer)}) 
+    {
+        records.push_back(makePayrollRecord(person));
+    }
+    cout << "Static Payroll: $" << totalPayroll(records) << endl;
+
+    {
+        ReportWriter roster(cout, CsvReport);
+        grad.render(roster);
+        prof.render(roster);
+        lecturer->render(roster);
+    }
+
+    PayrollReport report = PayrollEngine().run({&grad, &prof, lecturer}, university);
+    cout << "Payroll Engine: $" << report.total << " for " << report.people << " people";
+    for (auto& dept : report.departmentTotals) 
+    {
+        cout << ", " << dept.first << ": $" << dept.second;
+    }
+    cout << endl;
+
+    UniversityIndex index;
+    index.add(&grad);
+    index.addUniversity(university);
+    index.build();
+    auto grantsAbove = [](float amount) 
+    {
+        return [amount](const Person* person) 
+        {
+            const Professor* p = dynamic_cast<const Professor*>(person);
+            return p && p->getResearchGrants() > amount;
+        };
+    };
+    vector<pair<string, QueryResult>> queries;
+    queries.emplace_back("FullProfessors in CS with grants > $5000",
+                         PersonQuery(index).whereRole(RoleFullProfessor).where(FieldDepartment, "CS")
+                             .filter(grantsAbove(5000)).run());
+    queries.emplace_back("GraduateStudents advised by Dr. Smith",
+                         PersonQuery(index).where(FieldAdvisor, "Dr. Smith").run());
+    queries.emplace_back("Anyone with grants > $5000", PersonQuery(index).filter(grantsAbove(5000)).run());
+    for (auto& query : queries) 
+    {
+        cout << "Query " << query.first << ":";
+        for (size_t i = 0; i < query.second.size(); ++i) 
+        {
+            cout << " " << query.second[i]->getName();
+        }
+        cout << " [" << query.second.plan() << (query.second.borrowsIndex() ? ", borrowed" : ", owned") << "]" << endl;
+    }
+
+    if (!metricsPath.empty()) 
+    {
+        metrics().dump(metricsPath);
+    }
     return 0;
 }
\ No newline at end of file